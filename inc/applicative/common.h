@@ -25,6 +25,8 @@ typedef struct {
 	unsigned char lsmcu_series_traction;
 	unsigned char lsmcu_pbl2_on;
 	unsigned char lsmcu_urgency;
+	unsigned char lsmcu_fd_position; // SW3 state of FD.
+	unsigned char lsmcu_fpb_position; // SW3 state of FPB.
 	STEPPER_Context lsmcu_stepper_cp;
 	STEPPER_Context lsmcu_stepper_re;
 	STEPPER_Context lsmcu_stepper_cg;
@@ -39,6 +41,6 @@ typedef struct {
 
 /*** COMMMON global variables ***/
 
-LSMCU_Context lsmcu_ctx;
+extern LSMCU_Context lsmcu_ctx; // Defined in main.c.
 
 #endif /* COMMON_H */
@@ -24,16 +24,29 @@
 #define KVB_Y_00			((unsigned char*) " 00   ")
 #define KVB_G_000			((unsigned char*) "   000")
 #define KVB_Y_000			((unsigned char*) "000   ")
+// Brightness presets.
+#define KVB_BRIGHTNESS_DAY_PERCENT		100
+#define KVB_BRIGHTNESS_NIGHT_PERCENT	25
+// Sweep presets.
+#define KVB_REFRESH_RATE_STANDARD_HZ	80
+#define KVB_BLANKING_STANDARD_US		50
+#define KVB_REFRESH_RATE_CAMERA_HZ		300		// Multiple of 25, 30, 50 and 60 frames per second: no banding on video.
+#define KVB_BLANKING_CAMERA_US			20		// Shorter slots: blanking is reduced to keep the same brightness.
 
 /*** KVB functions ***/
 
 void KVB_Init(void);
 void KVB_StartSweepTimer(void);
 void KVB_StopSweepTimer(void);
+void KVB_SetRefreshRate(unsigned int refresh_rate_hz);
+void KVB_SetBlanking(unsigned int blanking_us);
+void KVB_SetBrightness(unsigned char display_idx, unsigned char brightness_percent);
+void KVB_SetBrightnessAll(unsigned char brightness_percent);
 void KVB_Display(unsigned char* display);
 void KVB_DisplayOff(void);
 void KVB_Sweep(void);
 void KVB_EnableBlinkLVAL(unsigned char blink_enabled);
+void KVB_ConfigureBlinkLVAL(unsigned int period_ms, unsigned char phase_percent);
 void KVB_EnableBlinkLSSF(unsigned char blink_enabled);
 void KVB_Task(void);
 
@@ -120,6 +120,27 @@ typedef enum {
 	LSMCU_IN_KVB_Y_00,
 	LSMCU_IN_KVB_G_000,
 	LSMCU_IN_KVB_Y_000,
+	// KVB brightness.
+	LSMCU_IN_KVB_YG_DAY,
+	LSMCU_IN_KVB_YG_NIGHT,
+	// Profiler (only handled when PROF_ENABLED is defined).
+	LSMCU_IN_PROF_DUMP,
+	LSMCU_IN_PROF_RESET,
+	// Histograms.
+	LSMCU_IN_HIST_DUMP,
+	LSMCU_IN_HIST_RESET,
+	// CPU load.
+	LSMCU_IN_LOAD_DUMP,
+	// PC sampler (only handled when PCS_ENABLED is defined).
+	LSMCU_IN_PCS_DUMP,
+	LSMCU_IN_PCS_RESET,
+	// Signal bus statistics.
+	LSMCU_IN_SIG_DUMP,
+	// Power manager statistics.
+	LSMCU_IN_PWRM_DUMP,
+	// KVB sweep timings.
+	LSMCU_IN_KVB_YG_SWEEP_STANDARD,
+	LSMCU_IN_KVB_YG_SWEEP_CAMERA,
 } LSSGKCU_To_LSMCU;
 
 /*** LSSGKCU functions ***/
@@ -10,31 +10,54 @@
 
 #include "stepper.h"
 
+/*** MANO macros ***/
+
+// Define MANO_MODEL_FPU to compute needle dynamics with single precision floats instead of Q16 fixed point.
+#ifdef MANO_MODEL_FPU
+typedef float MANO_ModelValue;
+#else
+typedef long long MANO_ModelValue; // Q16.
+#endif
+
 /*** MANO structures ***/
 
+// Needle second order model (mass-spring-damper), positions are expressed in steps.
+typedef struct {
+	MANO_ModelValue model_target; // Spring rest position.
+	MANO_ModelValue model_position;
+	MANO_ModelValue model_speed; // In steps/s.
+	MANO_ModelValue model_speed_max; // In steps/s.
+	MANO_ModelValue model_stiffness; // Square of the natural angular frequency (in 1/s^2).
+	MANO_ModelValue model_damping; // 2 * damping ratio * natural angular frequency (in 1/s).
+	unsigned char model_settled;
+} MANO_NeedleModel;
+
 typedef struct {
 	unsigned int mano_pressure_max_decibars;
 	unsigned int mano_pressure_max_steps;
-	unsigned int mano_needle_inertia_steps;
-	volatile unsigned char mano_enable;
 	STEPPER_Context* mano_stepper;
-	unsigned int mano_start_step;
-	volatile unsigned int mano_target_step;
-	volatile unsigned int mano_step_it_count; // Expressed in hundreds of s (number of timer interrupt calls).
-	volatile unsigned int mano_step_it_period; // Expressed in hundreds of s.
-	unsigned int mano_step_it_period_min; // Determines the maximum speed of the stepper.
+	volatile unsigned int mano_target_step; // Needle model output followed by the step scheduler.
+	volatile unsigned int mano_step_remaining_us; // Time before next step (0 when needle is stopped).
+	volatile unsigned int mano_step_period_us; // Step period given by needle model speed.
+	unsigned int mano_step_period_min_us; // Determines the maximum speed of the stepper.
+	unsigned int mano_natural_frequency_centihz;
+	unsigned int mano_damping_ratio_percent;
+	MANO_NeedleModel mano_model;
+	unsigned char mano_backup_idx; // Slot used to persist needle position in backup SRAM.
+	volatile unsigned char mano_homing;
 } MANO_Context;
 
 /*** MANO functions ***/
 
 void MANOS_Init(void);
 void MANOS_ManagePower(void);
-
-void MANO_Init(MANO_Context* mano, STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2, unsigned int pressure_max_decibars, unsigned int pressure_max_steps, unsigned int needle_inertia_steps, unsigned int needle_speed_max);
-void MANO_SetTarget(MANO_Context* mano, unsigned int pressure_decibars);
-unsigned int MANO_GetPressure(MANO_Context* mano);
-void MANO_StartNeedle(MANO_Context* mano);
-void MANO_StopNeedle(MANO_Context* mano);
-void MANO_NeedleTask(MANO_Context* mano);
+void MANOS_StepScheduler(void);
+void MANOS_Task(void);
+
+void MANO_Init(MANO_Context* mano, STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2, unsigned int pressure_max_decibars, unsigned int pressure_max_steps, unsigned int needle_speed_max);
+void MANO_SetNeedleDynamics(MANO_Context* mano, unsigned int natural_frequency_centihz, unsigned int damping_ratio_percent);
+void MANO_SetTargetMillibars(MANO_Context* mano, unsigned int pressure_millibars);
+unsigned int MANO_GetPressureMillibars(MANO_Context* mano);
+unsigned int MANO_NeedleTask(MANO_Context* mano, unsigned int elapsed_us);
 
 #endif /* APPLICATIVE_MANOS_H_ */
@@ -0,0 +1,28 @@
+/*
+ * pneu.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PNEU_H
+#define PNEU_H
+
+/*** PNEU structures ***/
+
+typedef enum {
+	PNEU_RESERVOIR_CP = 0, // Main reservoir.
+	PNEU_RESERVOIR_RE, // Equalizing reservoir.
+	PNEU_RESERVOIR_CG, // Brake pipe.
+	PNEU_RESERVOIR_CF1, // Brake cylinders of bogie 1.
+	PNEU_RESERVOIR_CF2, // Brake cylinders of bogie 2.
+	PNEU_RESERVOIR_LAST
+} PNEU_Reservoir;
+
+/*** PNEU functions ***/
+
+void PNEU_Init(void);
+unsigned int PNEU_GetPressure(PNEU_Reservoir reservoir);
+void PNEU_Task(void);
+
+#endif /* PNEU_H */
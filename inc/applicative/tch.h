@@ -10,12 +10,13 @@
 
 /*** TACHRO macros ***/
 
-// Maximum speed displayed on the Tachro (in km/h).
+// Maximum speed received from host (in km/h), step delay is computed for any speed.
 #define TCH_SPEED_MAX_KMH	160
 
 /*** TACHRO functions ***/
 
 void TCH_Init(void);
+void TCH_Commutate(void);
 void TCH_Task(void);
 
 #endif /* TCH_H */
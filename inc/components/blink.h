@@ -0,0 +1,35 @@
+/*
+ * blink.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef BLINK_H
+#define BLINK_H
+
+#include "gpio.h"
+
+/*** BLINK structures ***/
+
+typedef struct BLINK_Context {
+	const GPIO* blink_gpio;
+	unsigned int blink_off_duration_ms;
+	unsigned int blink_on_duration_ms;
+	volatile unsigned int blink_remaining_cycles; // 0 means infinite blinking.
+	volatile unsigned char blink_active;
+	volatile unsigned char blink_output_state;
+	volatile unsigned int blink_next_edge_time_ms;
+	struct BLINK_Context* blink_next;
+} BLINK_Context;
+
+/*** BLINK functions ***/
+
+void BLINK_Init(void);
+void BLINK_Register(BLINK_Context* blink, const GPIO* blink_gpio, unsigned int off_duration_ms, unsigned int on_duration_ms);
+void BLINK_Start(BLINK_Context* blink, unsigned int number_of_cycles);
+void BLINK_Stop(BLINK_Context* blink);
+unsigned char BLINK_IsActive(BLINK_Context* blink);
+void BLINK_Process(void);
+
+#endif /* BLINK_H */
@@ -0,0 +1,35 @@
+/*
+ * hist.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef HIST_H
+#define HIST_H
+
+/*** HIST macros ***/
+
+#define HIST_BUCKETS_NUMBER	33 // Bucket 0 counts null values, bucket n counts values from 2^(n-1) to (2^n)-1.
+
+/*** HIST structures ***/
+
+// Recorded histograms.
+typedef enum {
+	HIST_ID_MAIN_LOOP_PERIOD = 0, // Core cycles between two scheduler passes.
+	HIST_ID_TIM6_LATENCY, // Microseconds between TIM6 update event and interrupt handler entry.
+	HIST_ID_TIM7_LATENCY, // Microseconds between TIM7 update event and interrupt handler entry.
+	HIST_ID_USART1_RX_LATENCY, // Core cycles between byte reception and its decoding.
+	HIST_ID_TIM5_LATENCY, // Microseconds between TIM5 update event and interrupt handler entry (tachro step jitter).
+	HIST_ID_LAST
+} HIST_Id;
+
+/*** HIST functions ***/
+
+void HIST_Init(void);
+void HIST_Add(HIST_Id id, unsigned int value);
+void HIST_Reset(void);
+void HIST_StartDump(void);
+void HIST_Task(void);
+
+#endif /* HIST_H */
@@ -0,0 +1,30 @@
+/*
+ * load.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef LOAD_H
+#define LOAD_H
+
+/*** LOAD structures ***/
+
+// Moving average windows.
+typedef enum {
+	LOAD_WINDOW_1S = 0,
+	LOAD_WINDOW_10S,
+	LOAD_WINDOW_60S,
+	LOAD_WINDOW_LAST
+} LOAD_Window;
+
+/*** LOAD functions ***/
+
+void LOAD_Init(void);
+void LOAD_UpdateClock(void);
+void LOAD_AddSleepCycles(unsigned int sleep_cycles);
+unsigned int LOAD_GetPermille(LOAD_Window window);
+void LOAD_Send(void);
+void LOAD_Task(void);
+
+#endif /* LOAD_H */
@@ -0,0 +1,33 @@
+/*
+ * pcs.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PCS_H
+#define PCS_H
+
+/*** PCS macros ***/
+
+// Sampled code ranges (see tools/pc_sampling.py which uses the same values).
+#define PCS_CODE_BASE_ADDRESS		0x08000000
+#define PCS_BUCKET_SIZE_SHIFT		6 // 64 bytes per bucket.
+#define PCS_CODE_BUCKETS_NUMBER		2048 // 128kB of code in flash.
+#define PCS_ITCM_BASE_ADDRESS		0x00000000
+#define PCS_ITCM_BUCKETS_NUMBER		256 // 16kB of code in ITCM RAM.
+#define PCS_BUCKETS_NUMBER			(PCS_CODE_BUCKETS_NUMBER + PCS_ITCM_BUCKETS_NUMBER) // ITCM buckets follow flash buckets.
+
+/*** PCS functions ***/
+
+// Sampler only exists when PCS_ENABLED is defined in compiler options.
+#ifdef PCS_ENABLED
+void PCS_Init(void);
+void PCS_UpdateClock(void);
+void PCS_Sample(unsigned int pc);
+void PCS_Reset(void);
+void PCS_StartDump(void);
+void PCS_Task(void);
+#endif
+
+#endif /* PCS_H */
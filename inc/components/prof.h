@@ -0,0 +1,49 @@
+/*
+ * prof.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PROF_H
+#define PROF_H
+
+#include "sched.h"
+
+/*** PROF structures ***/
+
+// Profiled code sections.
+typedef enum {
+	PROF_ID_TIM2_IRQ = 0,
+	PROF_ID_TIM5_IRQ,
+	PROF_ID_TIM6_IRQ,
+	PROF_ID_TIM7_IRQ,
+	PROF_ID_USART1_IRQ,
+	PROF_ID_ADC_IRQ,
+	PROF_ID_TASK, // Scheduler tasks are profiled with identifier (PROF_ID_TASK + task index).
+	PROF_ID_LAST = (PROF_ID_TASK + SCHED_TASKS_NUMBER_MAX)
+} PROF_Id;
+
+/*** PROF macros ***/
+
+// Probes only exist when PROF_ENABLED is defined in compiler options, otherwise they expand to nothing.
+#ifdef PROF_ENABLED
+#define PROF_START(id)	PROF_Start(id)
+#define PROF_STOP(id)	PROF_Stop(id)
+#else
+#define PROF_START(id)
+#define PROF_STOP(id)
+#endif
+
+/*** PROF functions ***/
+
+#ifdef PROF_ENABLED
+void PROF_Init(void);
+void PROF_Start(PROF_Id id);
+void PROF_Stop(PROF_Id id);
+void PROF_Reset(void);
+void PROF_StartDump(void);
+void PROF_Task(void);
+#endif
+
+#endif /* PROF_H */
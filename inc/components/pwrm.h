@@ -0,0 +1,24 @@
+/*
+ * pwrm.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PWRM_H
+#define PWRM_H
+
+/*** PWRM macros ***/
+
+// Maximum time to restore profile clocks when the cab is powered. Standby keeps the profile clock
+// (peripherals are only gated) once a measured resume exceeds this bound.
+#define PWRM_RESUME_DURATION_MAX_US	2000
+
+/*** PWRM functions ***/
+
+void PWRM_Init(void);
+void PWRM_Wake(void);
+void PWRM_Send(void);
+void PWRM_Task(void);
+
+#endif /* PWRM_H */
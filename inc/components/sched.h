@@ -0,0 +1,48 @@
+/*
+ * sched.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+/*** SCHED macros ***/
+
+#define SCHED_TASKS_NUMBER_MAX	32
+
+/*** SCHED structures ***/
+
+// Events posted by interrupt handlers, signal bus or timer wheel.
+typedef enum {
+	SCHED_EVENT_USART1_RX,
+	SCHED_EVENT_ADC1_EOC,
+	SCHED_EVENT_SIGNAL,
+	SCHED_EVENT_TIMER,
+	SCHED_EVENT_LAST
+} SCHED_Event;
+
+#define SCHED_EVENT_NONE	SCHED_EVENT_LAST
+
+typedef struct {
+	void (*sched_task)(void);
+	unsigned int sched_period_ms; // 0 means the task is only run on event, or on every scheduler pass if it has no event.
+	SCHED_Event sched_event; // Event which triggers the task (SCHED_EVENT_NONE for periodic tasks).
+	unsigned char sched_priority; // Due tasks are run by ascending priority value.
+	unsigned int sched_next_run_time_ms;
+	unsigned int sched_run_count;
+	unsigned int sched_overrun_count; // Number of periods missed because the task was late by more than one period.
+} SCHED_Task;
+
+/*** SCHED functions ***/
+
+void SCHED_Init(void);
+void SCHED_Register(void (*task)(void), unsigned int period_ms, SCHED_Event event, unsigned char priority);
+void SCHED_PostEvent(SCHED_Event event);
+unsigned char SCHED_GetTaskCount(void);
+const SCHED_Task* SCHED_GetTask(unsigned char task_idx);
+void SCHED_Run(void);
+void SCHED_Sleep(void);
+
+#endif /* SCHED_H */
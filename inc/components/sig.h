@@ -0,0 +1,23 @@
+/*
+ * sig.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SIG_H
+#define SIG_H
+
+/*** SIG macros ***/
+
+#define SIG_SUBSCRIBERS_NUMBER_MAX	16
+
+/*** SIG functions ***/
+
+void SIG_Init(unsigned int polling_period_ms);
+void SIG_Subscribe(const unsigned char* signal, void (*handler)(void));
+void SIG_Write(unsigned char* signal, unsigned char value);
+void SIG_Send(void);
+void SIG_Task(void);
+
+#endif /* SIG_H */
@@ -10,18 +10,27 @@
 
 #include "gpio.h"
 
+/*** STEPPER macros ***/
+
+#define STEPPER_PORTS_MAX				2	// Maximum number of GPIO ports which can be written in a batch.
+
 /*** STEPPER structures ***/
 
 typedef struct {
 	const GPIO* stepper_cmd1;
 	const GPIO* stepper_cmd2;
 	volatile unsigned int stepper_current_step;
+	unsigned int stepper_phase_bsrr[4]; // BSRR word of each phase, both pins are written in a single store.
+	unsigned char stepper_port_idx; // Index of the port in batch table (STEPPER_PORTS_MAX if pins are on different ports).
 } STEPPER_Context;
 
 /*** STEPPER functions ***/
 
 void STEPPER_Init(STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2);
+void STEPPER_SetStep(STEPPER_Context* stepper, unsigned int step);
 void STEPPER_Up(STEPPER_Context* stepper);
 void STEPPER_Down(STEPPER_Context* stepper);
+void STEPPER_StartBatch(void);
+void STEPPER_EndBatch(void);
 
 #endif /* STEPPER_H */
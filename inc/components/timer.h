@@ -0,0 +1,42 @@
+/*
+ * timer.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/*** TIMER macros ***/
+
+#define TIMER_DELAY_MAX_MS	((0b1 << 20) - 1) // Range of the last wheel level (about 17 minutes).
+
+/*** TIMER structures ***/
+
+typedef enum {
+	TIMER_STATE_STOPPED,
+	TIMER_STATE_RUNNING,
+	TIMER_STATE_EXPIRED // Callback not run yet.
+} TIMER_State;
+
+typedef struct TIMER_Context {
+	void (*timer_callback)(void);
+	unsigned int timer_expiry_ms;
+	volatile TIMER_State timer_state;
+	struct TIMER_Context** timer_list; // List which contains the timer (wheel slot or expired list).
+	struct TIMER_Context* timer_next;
+	struct TIMER_Context* timer_previous;
+} TIMER_Context;
+
+/*** TIMER functions ***/
+
+void TIMER_Init(void);
+void TIMER_Register(TIMER_Context* timer, void (*callback)(void));
+void TIMER_Start(TIMER_Context* timer, unsigned int delay_ms);
+void TIMER_Stop(TIMER_Context* timer);
+unsigned char TIMER_IsRunning(TIMER_Context* timer);
+void TIMER_Process(void);
+void TIMER_Task(void);
+
+#endif /* TIMER_H */
@@ -11,6 +11,7 @@
 /*** ADC functions ***/
 
 void ADC1_Init(void);
+unsigned char ADC1_IsRunning(void);
 void ADC1_Task(void);
 
 #endif /* ADC_H */
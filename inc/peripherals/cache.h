@@ -0,0 +1,20 @@
+/*
+ * cache.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+/*** CACHE macros ***/
+
+#define CACHE_LINE_SIZE_BYTES	32
+
+/*** CACHE functions ***/
+
+void CACHE_Init(void);
+void CACHE_CleanData(void* address, unsigned int size_bytes);
+
+#endif /* CACHE_H */
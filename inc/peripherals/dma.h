@@ -0,0 +1,18 @@
+/*
+ * dma.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DMA_H
+#define DMA_H
+
+/*** DMA functions ***/
+
+// LVAL waveform (TIM8 update).
+void DMA2_InitStream1(void);
+void DMA2_StartStream1(unsigned int* source_buf, unsigned short source_buf_size);
+void DMA2_StopStream1(void);
+
+#endif /* DMA_H */
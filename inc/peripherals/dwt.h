@@ -0,0 +1,16 @@
+/*
+ * dwt.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DWT_H
+#define DWT_H
+
+/*** DWT functions ***/
+
+void DWT_Init(void);
+unsigned int DWT_GetCycleCount(void);
+
+#endif /* DWT_H */
@@ -113,10 +113,17 @@ typedef enum {
 	IT_SPDIFRX = 97
 } InterruptVector;
 
+/*** NVIC macros ***/
+
+// Priority of all peripheral interrupts (4 bits implemented in upper nibble), SysTick keeps priority 0 to sample them.
+#define NVIC_PRIORITY_PERIPHERAL	0x10
+
 /*** NVIC functions ***/
 
 void NVIC_EnableInterrupt(InterruptVector it_num);
 void NVIC_DisableInterrupt(InterruptVector it_num);
 void NVIC_SetPriority(InterruptVector it_num, unsigned char priority);
+void NVIC_MaskAllInterrupts(void);
+void NVIC_UnmaskAllInterrupts(void);
 
 #endif /* NVIC_H */
@@ -0,0 +1,22 @@
+/*
+ * pwr.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PWR_H
+#define PWR_H
+
+/*** PWR macros ***/
+
+#define PWR_BACKUP_SRAM_SIZE_WORDS	1024 // 4kB.
+
+/*** PWR functions ***/
+
+void PWR_EnableBackupSram(void);
+unsigned int PWR_ReadBackupSram(unsigned int word_idx);
+void PWR_WriteBackupSram(unsigned int word_idx, unsigned int value);
+void PWR_EnterSleepMode(void);
+
+#endif /* PWR_H */
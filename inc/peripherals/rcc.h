@@ -12,13 +12,46 @@
 
 // If defined, output clocks on MCO1 and MCO2 pins.
 //#define RCC_OUTPUT_CLOCK
+// Clock profile, selected with RCC_PROFILE_LOW_POWER or RCC_PROFILE_MAX_PERFORMANCE build flags (nominal otherwise).
+// Constraints on all profiles: PPRE1 and PPRE2 != 1 (timers clock = 2*PCLKx), 2*PCLK1 <= 65.536MHz (TIM2 1ms prescaler)
+// and PCLK2/2 <= 36MHz (ADC clock).
+#ifdef RCC_PROFILE_LOW_POWER
+// System clocks frequency in kHz.
+#define RCC_SYSCLK_KHZ	50000
+#define RCC_PCLK1_KHZ	25000
+#define RCC_PCLK2_KHZ	25000
+#else
+#ifdef RCC_PROFILE_MAX_PERFORMANCE
+// System clocks frequency in kHz.
+#define RCC_SYSCLK_KHZ	216000
+#define RCC_PCLK1_KHZ	27000
+#define RCC_PCLK2_KHZ	54000
+#else
+#define RCC_PROFILE_NOMINAL
 // System clocks frequency in kHz.
 #define RCC_SYSCLK_KHZ	100000
 #define RCC_PCLK1_KHZ	25000
 #define RCC_PCLK2_KHZ	25000
+#endif
+#endif
+// HSI frequency in kHz (always running: PLL source, standby system clock and USART1 kernel clock).
+#define RCC_HSI_KHZ		16000
+// Standby clocks frequency in kHz (HSI, PLL stopped). Peripherals gated in standby (TIM5/6/7/8 and ADC)
+// only run with the profile clocks, TIM2 and SysTick are reprogrammed on each switch.
+#define RCC_STANDBY_SYSCLK_KHZ	16000
+#define RCC_STANDBY_PCLK1_KHZ	8000
+#define RCC_STANDBY_PCLK2_KHZ	8000
 
 /*** RCC functions ***/
 
 void RCC_Init(void);
+void RCC_EnableRunPll(void);
+void RCC_SwitchToRunClock(void);
+void RCC_SwitchToStandbyClock(void);
+void RCC_DisableRunPll(void);
+void RCC_EnableDashboardClocks(unsigned char clocks_enabled);
+unsigned int RCC_GetSysclkKhz(void);
+unsigned int RCC_GetPclk1Khz(void);
+unsigned int RCC_GetPclk2Khz(void);
 
 #endif /* RCC_H */
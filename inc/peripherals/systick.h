@@ -0,0 +1,17 @@
+/*
+ * systick.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+/*** SYSTICK functions ***/
+
+void SYSTICK_Init(unsigned int period_cycles);
+void SYSTICK_Start(void);
+void SYSTICK_Stop(void);
+
+#endif /* SYSTICK_H */
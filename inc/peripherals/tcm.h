@@ -0,0 +1,24 @@
+/*
+ * tcm.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef TCM_H
+#define TCM_H
+
+/*** TCM macros ***/
+
+// Code and data placed in tightly coupled memories are copied from flash by the startup code (see LinkerScript.ld).
+// ITCM code executes without wait state nor cache miss, DTCM data is accessed without wait state nor cache miss.
+// Defining TCM_DISABLED in compiler options keeps everything in flash and SRAM (reference build for ISR cycles comparison).
+#ifdef TCM_DISABLED
+#define TCM_ITCM_FUNCTION
+#define TCM_DTCM_DATA
+#else
+#define TCM_ITCM_FUNCTION	__attribute__((section(".itcm_text")))
+#define TCM_DTCM_DATA		__attribute__((section(".dtcm_data")))
+#endif
+
+#endif /* TCM_H */
@@ -12,31 +12,48 @@
 
 // Milliseconds count.
 void TIM2_Init(void);
+void TIM2_SwitchClock(void (*clock_switch)(void));
 unsigned int TIM2_GetMs(void);
 void TIM2_DelayMs(unsigned ms_to_wait);
+void TIM2_SetCompareMs(unsigned int compare_ms);
+void TIM2_EnableCompareInterrupt(unsigned char it_enabled);
+void TIM2_ForceCompareEvent(void);
+void TIM2_SetWakeUpMs(unsigned int wake_up_ms);
+void TIM2_SetTickMs(unsigned int tick_ms);
+void TIM2_DisableTick(void);
+void TIM2_ForceTickEvent(void);
 
 // Tachro step timer
 void TIM5_Init(void);
 void TIM5_Start(void);
 void TIM5_Stop(void);
-void TIM5_SetDelayUs(unsigned int arr_value);
-unsigned char TIM5_GetUifFlag(void);
-void TIM5_ClearUifFlag(void);
+unsigned char TIM5_IsRunning(void);
+void TIM5_SetDelayUs(unsigned int delay_us);
 
 // KVB.
 void TIM6_Init(void);
 void TIM6_Start(void);
 void TIM6_Stop(void);
+unsigned char TIM6_IsRunning(void);
+void TIM6_SetDelayUs(unsigned int delay_us);
 
 // Manometers.
 void TIM7_Init(void);
 void TIM7_Start(void);
 void TIM7_Stop(void);
+unsigned char TIM7_IsRunning(void);
+void TIM7_SetDelayUs(unsigned int delay_us);
+unsigned int TIM7_GetCounterUs(void);
+void TIM7_ResetCounter(void);
+unsigned char TIM7_GetUifFlag(void);
 
 // LVAL PWM.
 void TIM8_Init(void);
 void TIM8_SetDutyCycle(unsigned char duty_cycle);
+void TIM8_SetUpdatePeriods(unsigned int pwm_periods);
+void TIM8_EnableUpdateDma(unsigned char dma_enabled);
 void TIM8_Start(void);
 void TIM8_Stop(void);
+unsigned char TIM8_IsRunning(void);
 
 #endif /* TIM_H */
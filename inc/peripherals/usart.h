@@ -22,5 +22,6 @@ typedef enum {
 
 void USART1_Init(void);
 void USART1_SendByte(unsigned char tx_byte, USART_Format format);
+void USART1_SendWord(unsigned int tx_word);
 
 #endif /* _USART_H */
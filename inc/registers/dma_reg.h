@@ -0,0 +1,35 @@
+/*
+ * dma_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DMA_REG_H
+#define DMA_REG_H
+
+/*** DMA registers ***/
+
+typedef struct {
+	volatile unsigned int CR;    	// DMA stream x configuration register.
+	volatile unsigned int NDTR;    	// DMA stream x number of data register.
+	volatile unsigned int PAR;    	// DMA stream x peripheral address register.
+	volatile unsigned int M0AR;    	// DMA stream x memory 0 address register.
+	volatile unsigned int M1AR;    	// DMA stream x memory 1 address register.
+	volatile unsigned int FCR;    	// DMA stream x FIFO control register.
+} DMA_StreamBaseAddress;
+
+typedef struct {
+	volatile unsigned int LISR;    			// DMA low interrupt status register.
+	volatile unsigned int HISR;    			// DMA high interrupt status register.
+	volatile unsigned int LIFCR;    		// DMA low interrupt flag clear register.
+	volatile unsigned int HIFCR;    		// DMA high interrupt flag clear register.
+	DMA_StreamBaseAddress STREAM[8];		// DMA streams 0 to 7.
+} DMA_BaseAddress;
+
+/*** DMA base addresses ***/
+
+#define DMA1	((DMA_BaseAddress*) ((unsigned int) 0x40026000))
+#define DMA2	((DMA_BaseAddress*) ((unsigned int) 0x40026400))
+
+#endif /* DMA_REG_H */
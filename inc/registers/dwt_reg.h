@@ -0,0 +1,32 @@
+/*
+ * dwt_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef DWT_REG_H
+#define DWT_REG_H
+
+/*** DWT registers ***/
+
+typedef struct {
+	volatile unsigned int CTRL;			// Control register.
+	volatile unsigned int CYCCNT;		// Cycle count register.
+	volatile unsigned int CPICNT;		// CPI count register.
+	volatile unsigned int EXCCNT;		// Exception overhead count register.
+	volatile unsigned int SLEEPCNT;		// Sleep count register.
+	volatile unsigned int LSUCNT;		// LSU count register.
+	volatile unsigned int FOLDCNT;		// Folded-instruction count register.
+	volatile unsigned int PCSR;			// Program counter sample register.
+	unsigned int RESERVED0[996];		// Reserved 0xE0001020 to 0xE0001FAC.
+	volatile unsigned int LAR;			// Lock access register.
+	volatile unsigned int LSR;			// Lock status register.
+} DWT_BaseAddress;
+
+/*** DWT base addresses ***/
+
+#define DWT		((DWT_BaseAddress*) ((unsigned int) 0xE0001000))
+#define DEMCR	((volatile unsigned int*) ((unsigned int) 0xE000EDFC)) // Debug exception and monitor control register.
+
+#endif /* DWT_REG_H */
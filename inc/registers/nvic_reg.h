@@ -17,15 +17,21 @@ typedef struct {
 	unsigned int RESERVED1[24];			// Reserved 0xE000E1A0.
 	volatile unsigned int ISPR[8];		// Interrupt set-pending registers 0 to 7.
 	unsigned int RESERVED2[24];			// Reserved 0xE000E220.
-	volatile unsigned int ICPR;    		// Interrupt clear-pending registers 0 to 7.
-	unsigned int RESERVED3[24];			// Reserved 0xE000E300.
+	volatile unsigned int ICPR[8];		// Interrupt clear-pending registers 0 to 7.
+	unsigned int RESERVED3[24];			// Reserved 0xE000E2A0.
 	volatile unsigned int IABR[8];		// Interrupt active bit registers 0 to 7.
 	unsigned int RESERVED4[56];			// Reserved 0xE000E320.
-	volatile unsigned char IPR[240];	// Interrupt active bit registers 0 to 7.
+	volatile unsigned char IPR[240];	// Interrupt priority registers 0 to 239.
 	unsigned int RESERVED5[644];		// Reserved 0xE000E4F0.
 	volatile unsigned int STIR;    		// Interrupt software trigger register.
 } NVIC_BaseAddress;
 
+// Registers offsets from NVIC base address (0xE000E100).
+_Static_assert(__builtin_offsetof(NVIC_BaseAddress, ICPR) == 0x180, "NVIC ICPR offset");
+_Static_assert(__builtin_offsetof(NVIC_BaseAddress, IABR) == 0x200, "NVIC IABR offset");
+_Static_assert(__builtin_offsetof(NVIC_BaseAddress, IPR) == 0x300, "NVIC IPR offset");
+_Static_assert(__builtin_offsetof(NVIC_BaseAddress, STIR) == 0xE00, "NVIC STIR offset");
+
 /*** NVIC base address ***/
 
 #define NVIC	((NVIC_BaseAddress*) ((unsigned int) 0xE000E100))
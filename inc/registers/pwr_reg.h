@@ -0,0 +1,28 @@
+/*
+ * pwr_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef PWR_REG_H
+#define PWR_REG_H
+
+/*** PWR registers ***/
+
+typedef struct {
+	volatile unsigned int CR1;    	// Power control register 1.
+	volatile unsigned int CSR1;    	// Power control and status register 1.
+	volatile unsigned int CR2;    	// Power control register 2.
+	volatile unsigned int CSR2;    	// Power control and status register 2.
+} PWR_BaseAddress;
+
+/*** PWR base addresses ***/
+
+#define PWR			((PWR_BaseAddress*) ((unsigned int) 0x40007000))
+
+/*** Backup SRAM base address ***/
+
+#define BKPSRAM		((volatile unsigned int*) ((unsigned int) 0x40024000))
+
+#endif /* PWR_REG_H */
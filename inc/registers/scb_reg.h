@@ -0,0 +1,45 @@
+/*
+ * scb_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SCB_REG_H
+#define SCB_REG_H
+
+/*** SCB registers ***/
+
+typedef struct {
+	volatile unsigned int CPUID;		// CPUID base register.
+	volatile unsigned int ICSR;			// Interrupt control and state register.
+	volatile unsigned int VTOR;			// Vector table offset register.
+	volatile unsigned int AIRCR;		// Application interrupt and reset control register.
+	volatile unsigned int SCR;			// System control register.
+	volatile unsigned int CCR;			// Configuration and control register.
+	volatile unsigned char SHPR[12];	// System handler priority registers 1 to 3.
+	volatile unsigned int SHCSR;		// System handler control and state register.
+	unsigned int RESERVED0[20];			// Fault status and feature registers 0x28 to 0x74.
+	volatile unsigned int CLIDR;		// Cache level ID register.
+	volatile unsigned int CTR;			// Cache type register.
+	volatile unsigned int CCSIDR;		// Cache size ID register.
+	volatile unsigned int CSSELR;		// Cache size selection register.
+	volatile unsigned int CPACR;		// Coprocessor access control register.
+	unsigned int RESERVED1[113];		// Reserved 0x8C to 0x24C.
+	volatile unsigned int ICIALLU;		// Instruction cache invalidate all to PoU.
+	unsigned int RESERVED2;				// Reserved 0x254.
+	volatile unsigned int ICIMVAU;		// Instruction cache invalidate by address to PoU.
+	volatile unsigned int DCIMVAC;		// Data cache invalidate by address to PoC.
+	volatile unsigned int DCISW;		// Data cache invalidate by set/way.
+	volatile unsigned int DCCMVAU;		// Data cache clean by address to PoU.
+	volatile unsigned int DCCMVAC;		// Data cache clean by address to PoC.
+	volatile unsigned int DCCSW;		// Data cache clean by set/way.
+	volatile unsigned int DCCIMVAC;		// Data cache clean and invalidate by address to PoC.
+	volatile unsigned int DCCISW;		// Data cache clean and invalidate by set/way.
+} SCB_BaseAddress;
+
+/*** SCB base address ***/
+
+#define SCB		((SCB_BaseAddress*) ((unsigned int) 0xE000ED00))
+
+#endif /* SCB_REG_H */
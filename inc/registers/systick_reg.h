@@ -0,0 +1,24 @@
+/*
+ * systick_reg.h
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#ifndef SYSTICK_REG_H
+#define SYSTICK_REG_H
+
+/*** SYSTICK registers ***/
+
+typedef struct {
+	volatile unsigned int CTRL;		// Control and status register.
+	volatile unsigned int LOAD;		// Reload value register.
+	volatile unsigned int VAL;		// Current value register.
+	volatile unsigned int CALIB;	// Calibration value register.
+} SYSTICK_BaseAddress;
+
+/*** SYSTICK base address ***/
+
+#define SYSTICK		((SYSTICK_BaseAddress*) ((unsigned int) 0xE000E010))
+
+#endif /* SYSTICK_REG_H */
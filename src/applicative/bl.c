@@ -12,6 +12,7 @@
 #include "kvb.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw2.h"
 
 /*** BL local structures ***/
@@ -74,7 +75,7 @@ void BL_Task(void) {
 			LSSGKCU_Send(LSMCU_OUT_ZDV_ON);
 			KVB_StartSweepTimer();
 		}
-		lsmcu_ctx.lsmcu_bl_unlocked = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_bl_unlocked), 1);
 	}
 	else {
 		// Send command on change.
@@ -82,13 +83,13 @@ void BL_Task(void) {
 			LSSGKCU_Send(LSMCU_OUT_ZDV_OFF);
 			KVB_StopSweepTimer();
 		}
-		lsmcu_ctx.lsmcu_bl_unlocked = 0;
+		SIG_Write(&(lsmcu_ctx.lsmcu_bl_unlocked), 0);
 	}
 	// ZDJ.
 	SW2_UpdateState(&bl_ctx.bl_zdj);
 	if (lsmcu_ctx.lsmcu_zpt_raised != 0) {
 		if (bl_ctx.bl_zdj.sw2_state == SW2_ON) {
-			lsmcu_ctx.lsmcu_dj_closed = 1;
+			SIG_Write(&(lsmcu_ctx.lsmcu_dj_closed), 1);
 		}
 		else {
 			// Send command on change (only if DJ is locked).
@@ -96,17 +97,17 @@ void BL_Task(void) {
 				if (lsmcu_ctx.lsmcu_dj_locked != 0) {
 					LSSGKCU_Send(LSMCU_OUT_ZDJ_OFF);
 				}
-				lsmcu_ctx.lsmcu_dj_locked = 0;
+				SIG_Write(&(lsmcu_ctx.lsmcu_dj_locked), 0);
 			}
-			lsmcu_ctx.lsmcu_dj_closed = 0;
+			SIG_Write(&(lsmcu_ctx.lsmcu_dj_closed), 0);
 		}
 	}
 	else {
 		if (lsmcu_ctx.lsmcu_dj_closed != 0) {
 			LSSGKCU_Send(LSMCU_OUT_ZDJ_OFF);
 		}
-		lsmcu_ctx.lsmcu_dj_closed = 0; // Hack.
-		lsmcu_ctx.lsmcu_dj_locked = 0;
+		SIG_Write(&(lsmcu_ctx.lsmcu_dj_closed), 0); // Hack.
+		SIG_Write(&(lsmcu_ctx.lsmcu_dj_locked), 0);
 	}
 	// ZEN.
 	SW2_UpdateState(&bl_ctx.bl_zen);
@@ -115,7 +116,7 @@ void BL_Task(void) {
 			// Send command on change.
 			if ((bl_ctx.bl_zen_on == 0) && (lsmcu_ctx.lsmcu_dj_locked == 0)) {
 				LSSGKCU_Send(LSMCU_OUT_ZEN_ON);
-				lsmcu_ctx.lsmcu_dj_locked = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_dj_locked), 1);
 			}
 			bl_ctx.bl_zen_on = 1;
 		}
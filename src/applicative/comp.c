@@ -9,8 +9,9 @@
 
 #include "common.h"
 #include "lssgkcu.h"
-#include "mano.h"
 #include "mapping.h"
+#include "pneu.h"
+#include "sig.h"
 #include "sw2.h"
 
 /*** COMP macros ***/
@@ -18,7 +19,6 @@
 #define COMP_CP_HYSTERESIS_LOW_DECIBARS 		78 // Low threshold of regulation hysteresis.
 #define COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS	8 // Pressure range within which no off command is sent (sound will stop by itself).
 #define COMP_CP_HYSTERESIS_HIGH_DECIBARS 		90 // High threshold of regulation hysteresis.
-#define COMP_CP_MAXIMUM_VALUE_DECIBARS	 		95 // Maximum value displayed.
 
 /*** COMP local structures ***/
 
@@ -64,6 +64,8 @@ void COMP_Init(void) {
  * @return:	None.
  */
 void COMP_Task(void) {
+	// Main reservoir pressure given by pneumatic model.
+	unsigned int cp_decibars = (PNEU_GetPressure(PNEU_RESERVOIR_CP) / 100);
 	// Update ZCA.
 	if (lsmcu_ctx.lsmcu_dj_locked != 0) {
 		SW2_UpdateState(&comp_ctx.comp_zca);
@@ -73,15 +75,13 @@ void COMP_Task(void) {
 	switch (comp_ctx.comp_state) {
 	case COMP_STATE_OFF:
 		// Update global context.
-		lsmcu_ctx.lsmcu_compressor_on = 0;
+		SIG_Write(&(lsmcu_ctx.lsmcu_compressor_on), 0);
 		// Check DJ.
 		if (lsmcu_ctx.lsmcu_dj_locked != 0) {
 			// ZCD overrides ZCA.
 			if (comp_ctx.comp_zcd.sw2_state == SW2_ON) {
-				// Play direct sound and set CP needle to maximum.
+				// Play direct sound.
 				LSSGKCU_Send(LSMCU_OUT_COMP_DIRECT_ON);
-				MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-				MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 				// Compute next state.
 				comp_ctx.comp_state = COMP_STATE_DIRECT;
 
@@ -89,9 +89,9 @@ void COMP_Task(void) {
 			else {
 				if (comp_ctx.comp_zca.sw2_state == SW2_ON) {
 					// Check CP value.
-					if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
+					if (cp_decibars < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
 						// Play accurate sound.
-						if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
+						if (cp_decibars > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
 							// Play minimum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MIN_ON);
 							comp_ctx.comp_sound_auto_off = 1;
@@ -99,22 +99,18 @@ void COMP_Task(void) {
 						else {
 							// Play maximum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MAX_ON);
-							if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
+							if (cp_decibars < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
 								comp_ctx.comp_sound_auto_off = 1;
 							}
 							else {
 								comp_ctx.comp_sound_auto_off = 0;
 							}
 						}
-						// Set CP needle to maximum (will be stopped by hysteresis).
-						MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-						MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_ON;
 					}
 					else {
 						// Auto mode in off zone.
-						MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_OFF;
 					}
@@ -124,22 +120,19 @@ void COMP_Task(void) {
 		break;
 	case COMP_STATE_AUTO_ON:
 		// Update global context.
-		lsmcu_ctx.lsmcu_compressor_on = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_compressor_on), 1);
 		// Check DJ
 		if (lsmcu_ctx.lsmcu_dj_locked == 0) {
 			// Stop compressor.
 			LSSGKCU_Send(LSMCU_OUT_COMP_OFF);
-			MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 			// Compute next state.
 			comp_ctx.comp_state = COMP_STATE_OFF;
 		}
 		else {
 			// ZCD overrides ZCA.
 			if (comp_ctx.comp_zcd.sw2_state == SW2_ON) {
-				// Play direct sound and set CP needle to maximum.
+				// Play direct sound.
 				LSSGKCU_Send(LSMCU_OUT_COMP_DIRECT_ON);
-				MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-				MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 				// Compute next state.
 				comp_ctx.comp_state = COMP_STATE_DIRECT;
 
@@ -147,12 +140,11 @@ void COMP_Task(void) {
 			else {
 				if (comp_ctx.comp_zca.sw2_state == SW2_ON) {
 					// Perform hysterersis.
-					if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) > COMP_CP_HYSTERESIS_HIGH_DECIBARS) {
+					if (cp_decibars > COMP_CP_HYSTERESIS_HIGH_DECIBARS) {
 						// Stop regulation.
 						if (comp_ctx.comp_sound_auto_off == 0) {
 							LSSGKCU_Send(LSMCU_OUT_COMP_OFF);
 						}
-						MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_OFF;
 					}
@@ -160,7 +152,6 @@ void COMP_Task(void) {
 				else {
 					// Compressor off.
 					LSSGKCU_Send(LSMCU_OUT_COMP_OFF);
-					MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 					// Compute next state.
 					comp_ctx.comp_state = COMP_STATE_OFF;
 				}
@@ -169,7 +160,7 @@ void COMP_Task(void) {
 		break;
 	case COMP_STATE_AUTO_OFF:
 		// Update global context.
-		lsmcu_ctx.lsmcu_compressor_on = 0;
+		SIG_Write(&(lsmcu_ctx.lsmcu_compressor_on), 0);
 		// Check DJ
 		if (lsmcu_ctx.lsmcu_dj_locked == 0) {
 			// Compute next state.
@@ -178,10 +169,8 @@ void COMP_Task(void) {
 		else {
 			// ZCD overrides ZCA.
 			if (comp_ctx.comp_zcd.sw2_state == SW2_ON) {
-				// Play direct sound and set CP needle to maximum.
+				// Play direct sound.
 				LSSGKCU_Send(LSMCU_OUT_COMP_DIRECT_ON);
-				MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-				MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 				// Compute next state.
 				comp_ctx.comp_state = COMP_STATE_DIRECT;
 
@@ -189,9 +178,9 @@ void COMP_Task(void) {
 			else {
 				if (comp_ctx.comp_zca.sw2_state == SW2_ON) {
 					// Check CP value.
-					if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
+					if (cp_decibars < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
 						// Play accurate sound.
-						if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
+						if (cp_decibars > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
 							// Play minimum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MIN_ON);
 							comp_ctx.comp_sound_auto_off = 1;
@@ -199,16 +188,13 @@ void COMP_Task(void) {
 						else {
 							// Play maximum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MAX_ON);
-							if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
+							if (cp_decibars < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
 								comp_ctx.comp_sound_auto_off = 1;
 							}
 							else {
 								comp_ctx.comp_sound_auto_off = 0;
 							}
 						}
-						// Set CP needle to maximum (will be stopped by hysteresis).
-						MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-						MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_ON;
 					}
@@ -222,12 +208,11 @@ void COMP_Task(void) {
 		break;
 	case COMP_STATE_DIRECT:
 		// Update global context.
-		lsmcu_ctx.lsmcu_compressor_on = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_compressor_on), 1);
 		// Check DJ
 		if (lsmcu_ctx.lsmcu_dj_locked == 0) {
 			// Stop compressor.
 			LSSGKCU_Send(LSMCU_OUT_COMP_OFF);
-			MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 			// Compute next state.
 			comp_ctx.comp_state = COMP_STATE_OFF;
 		}
@@ -237,9 +222,9 @@ void COMP_Task(void) {
 				// Check ZCA.
 				if (comp_ctx.comp_zca.sw2_state == SW2_ON) {
 					// Check CP value.
-					if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
+					if (cp_decibars < COMP_CP_HYSTERESIS_LOW_DECIBARS) {
 						// Play accurate sound.
-						if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
+						if (cp_decibars > (COMP_CP_HYSTERESIS_LOW_DECIBARS - COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS)) {
 							// Play minimum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MIN_ON);
 							comp_ctx.comp_sound_auto_off = 1;
@@ -247,22 +232,18 @@ void COMP_Task(void) {
 						else {
 							// Play maximum regulation sound.
 							LSSGKCU_Send(LSMCU_OUT_COMP_AUTO_REG_MAX_ON);
-							if (MANO_GetPressure(&(lsmcu_ctx.lsmcu_mano_cp)) < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
+							if (cp_decibars < COMP_CP_SOUND_AUTO_OFF_RANGE_DECIBARS) {
 								comp_ctx.comp_sound_auto_off = 1;
 							}
 							else {
 								comp_ctx.comp_sound_auto_off = 0;
 							}
 						}
-						// Set CP needle to maximum (will be stopped by hysteresis).
-						MANO_SetTarget(&(lsmcu_ctx.lsmcu_mano_cp), COMP_CP_MAXIMUM_VALUE_DECIBARS);
-						MANO_StartNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_ON;
 					}
 					else {
 						// Auto mode in off zone.
-						MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 						// Compute next state.
 						comp_ctx.comp_state = COMP_STATE_AUTO_OFF;
 					}
@@ -270,7 +251,6 @@ void COMP_Task(void) {
 				else {
 					// Stop compressor.
 					LSSGKCU_Send(LSMCU_OUT_COMP_OFF);
-					MANO_StopNeedle(&(lsmcu_ctx.lsmcu_mano_cp));
 					// Compute next state.
 					comp_ctx.comp_state = COMP_STATE_OFF;
 				}
@@ -11,7 +11,7 @@
 #include "gpio.h"
 #include "mapping.h"
 #include "sw2.h"
-#include "tim.h"
+#include "timer.h"
 
 /*** DEP local macros ***/
 
@@ -32,13 +32,46 @@ typedef struct {
 	SW2_Context dep_zlct;
 	// State machine.
 	DEP_State dep_state;
-	unsigned int dep_switch_state_time; // In ms.
+	TIMER_Context dep_timer; // Ring pulses.
 } DEP_Context;
 
 /*** DEP local global variables ***/
 
 static DEP_Context dep_ctx;
 
+/*** DEP local functions ***/
+
+/* PERFORM RING PULSES SEQUENCE (CALLED BY TIMER_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void DEP_TimerCallback(void) {
+	switch (dep_ctx.dep_state) {
+	case DEP_STATE_RING1:
+		// Release.
+		GPIO_Write(&GPIO_DEP, 0);
+		TIMER_Start(&dep_ctx.dep_timer, DEP_RING_PULSE_DURATION_MS);
+		dep_ctx.dep_state = DEP_STATE_RELEASE1;
+		break;
+	case DEP_STATE_RELEASE1:
+		// Second ring.
+		GPIO_Write(&GPIO_DEP, 1);
+		TIMER_Start(&dep_ctx.dep_timer, DEP_RING_PULSE_DURATION_MS);
+		dep_ctx.dep_state = DEP_STATE_RING2;
+		break;
+	case DEP_STATE_RING2:
+		// Release.
+		GPIO_Write(&GPIO_DEP, 0);
+		dep_ctx.dep_state = DEP_STATE_DISABLED;
+		break;
+	default:
+		// No deadline in other states.
+		break;
+	}
+}
+
+/*** DEP functions ***/
+
 /* INIT DEP MODULE.
  * @param:	None.
  * @return:	None.
@@ -49,7 +82,7 @@ void DEP_Init(void) {
 	GPIO_Configure(&GPIO_DEP, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	// Init context.
 	dep_ctx.dep_state = DEP_STATE_ENABLED;
-	dep_ctx.dep_switch_state_time = 0;
+	TIMER_Register(&dep_ctx.dep_timer, &DEP_TimerCallback);
 }
 
 void DEP_Task(void) {
@@ -61,33 +94,14 @@ void DEP_Task(void) {
 		if ((lsmcu_ctx.lsmcu_speed_kmh == 0) && (dep_ctx.dep_zlct.sw2_state == SW2_ON)) {
 			// First ring.
 			GPIO_Write(&GPIO_DEP, 1);
-			dep_ctx.dep_switch_state_time = TIM2_GetMs();
+			TIMER_Start(&dep_ctx.dep_timer, DEP_RING_PULSE_DURATION_MS);
 			dep_ctx.dep_state = DEP_STATE_RING1;
 		}
 		break;
 	case DEP_STATE_RING1:
-		if (TIM2_GetMs() > (dep_ctx.dep_switch_state_time + DEP_RING_PULSE_DURATION_MS)) {
-			// Release.
-			GPIO_Write(&GPIO_DEP, 0);
-			dep_ctx.dep_switch_state_time = TIM2_GetMs();
-			dep_ctx.dep_state = DEP_STATE_RELEASE1;
-		}
-		break;
 	case DEP_STATE_RELEASE1:
-		if (TIM2_GetMs() > (dep_ctx.dep_switch_state_time + DEP_RING_PULSE_DURATION_MS)) {
-			// Second ring.
-			GPIO_Write(&GPIO_DEP, 1);
-			dep_ctx.dep_switch_state_time = TIM2_GetMs();
-			dep_ctx.dep_state = DEP_STATE_RING2;
-		}
-		break;
 	case DEP_STATE_RING2:
-		if (TIM2_GetMs() > (dep_ctx.dep_switch_state_time + DEP_RING_PULSE_DURATION_MS)) {
-			// Release.
-			GPIO_Write(&GPIO_DEP, 0);
-			dep_ctx.dep_switch_state_time = TIM2_GetMs();
-			dep_ctx.dep_state = DEP_STATE_DISABLED;
-		}
+		// Ring pulses are sequenced by timer callback.
 		break;
 	case DEP_STATE_DISABLED:
 		// Enable bell on next stop.
@@ -7,9 +7,11 @@
 
 #include "fd.h"
 
+#include "common.h"
 #include "gpio.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw3.h"
 
 /*** FD local structures ***/
@@ -76,5 +78,7 @@ void FD_Task(void) {
 	}
 	// Update previous state.
 	fd_ctx.fd_previous_state = fd_ctx.fd_sw3.sw3_state;
+	// Update global context.
+	SIG_Write(&(lsmcu_ctx.lsmcu_fd_position), fd_ctx.fd_sw3.sw3_state);
 }
 
@@ -11,6 +11,7 @@
 #include "gpio.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw3.h"
 
 /*** FPB local structures ***/
@@ -79,6 +80,8 @@ void FPB_Task(void) {
 	}
 	// Update previous state.
 	fpb_ctx.fpb_previous_state = fpb_ctx.fpb_sw3.sw3_state;
+	// Update global context.
+	SIG_Write(&(lsmcu_ctx.lsmcu_fpb_position), fpb_ctx.fpb_sw3.sw3_state);
 
 }
 
@@ -7,10 +7,12 @@
 
 #include "il.h"
 
+#include "blink.h"
 #include "common.h"
 #include "gpio.h"
 #include "mapping.h"
-#include "tim.h"
+#include "sig.h"
+#include "timer.h"
 
 /*** IL local macros ***/
 
@@ -52,8 +54,8 @@ typedef enum {
 
 typedef struct {
 	IL_State il_state;
-	unsigned long il_switch_state_time; // In ms.
-	unsigned long il_lsrh_blink_start_time; // In ms.
+	TIMER_Context il_timer; // Lights sequences.
+	BLINK_Context il_lsrh_blink;
 } IL_Context;
 
 /*** IL local global variables ***/
@@ -67,6 +69,8 @@ static IL_Context il_ctx;
  * @return:					None.
  */
 void IL_SetState(unsigned int il_state_mask) {
+	// Cancel LSRH blinking if any.
+	BLINK_Stop(&(il_ctx.il_lsrh_blink));
 	// Set all lights state.
 	GPIO_Write(&GPIO_LSDJ, (il_state_mask & (0b1 << IL_LSDJ_BIT_INDEX)));
 	GPIO_Write(&GPIO_LSGR, (il_state_mask & (0b1 << IL_LSGR_BIT_INDEX)));
@@ -79,35 +83,43 @@ void IL_SetState(unsigned int il_state_mask) {
 	GPIO_Write(&GPIO_LSRH, (il_state_mask & (0b1 << IL_LSRH_BIT_INDEX)));
 }
 
-/*** IL functions ***/
-
-/* INIT IL MODULE.
+/* UPDATE TRACTION LIGHTS WHEN DJ IS LOCKED (CALLED ON STATE ENTRY AND ON SIGNAL CHANGE).
  * @param:	None.
  * @return:	None.
  */
-void IL_Init(void) {
-	// Init GPIOs.
-	GPIO_Configure(&GPIO_LSDJ, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSGR, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSS, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSCB, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSP, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSPAT, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSBA, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSPI, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_LSRH, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	IL_SetState(0);
-	// Init context.
-	il_ctx.il_state = IL_STATE_OFF;
-	// Init global context.
-	lsmcu_ctx.lsmcu_lsrh_blink_request = 0;
+void IL_UpdateTractionLights(void) {
+	if (il_ctx.il_state == IL_STATE_DJ_LOCKED) {
+		// Manage LSGR, LSS and LSP.
+		GPIO_Write(&GPIO_LSGR, (lsmcu_ctx.lsmcu_rheostat_0 != 0));
+		GPIO_Write(&GPIO_LSS, ((lsmcu_ctx.lsmcu_rheostat_0 == 0) && (lsmcu_ctx.lsmcu_series_traction != 0)));
+		GPIO_Write(&GPIO_LSP, ((lsmcu_ctx.lsmcu_rheostat_0 == 0) && (lsmcu_ctx.lsmcu_series_traction == 0)));
+		// Manage LSRH.
+		if (lsmcu_ctx.lsmcu_rheostat_0 == 0) {
+			// LSRH is driven by the blink engine during blinking.
+			if (BLINK_IsActive(&(il_ctx.il_lsrh_blink)) == 0) {
+				if ((lsmcu_ctx.lsmcu_lsrh_blink_request != 0) && (GPIO_Read(&GPIO_LSRH) != 0)) {
+					// Single off-on cycle, LSRH is turned on again at the end.
+					BLINK_Start(&(il_ctx.il_lsrh_blink), 1);
+				}
+				else {
+					GPIO_Write(&GPIO_LSRH, 1);
+				}
+			}
+			// Consume request without notifying subscribers (this handler would be run again for nothing).
+			lsmcu_ctx.lsmcu_lsrh_blink_request = 0;
+		}
+		else {
+			BLINK_Stop(&(il_ctx.il_lsrh_blink));
+			GPIO_Write(&GPIO_LSRH, 0);
+		}
+	}
 }
 
-/* MAIN TASK OF IL MODULE.
+/* PERFORM ONE TRANSITION OF IL STATE MACHINE.
  * @param:	None.
  * @return:	None.
  */
-void IL_Task(void) {
+void IL_UpdateState(void) {
 	// Perform state machine.
 	switch (il_ctx.il_state) {
 	case IL_STATE_OFF:
@@ -116,40 +128,19 @@ void IL_Task(void) {
 			// Turn LSDJ on.
 			IL_SetState(0b000000001);
 			// Compute next state.
-			il_ctx.il_switch_state_time = TIM2_GetMs();
+			TIMER_Start(&(il_ctx.il_timer), IL_ZBA_CLOSED_LSGR_DELAY_MS);
 			il_ctx.il_state = IL_STATE_ZBA_CLOSED_TRANSITION1;
 		}
 		break;
 	case IL_STATE_ZBA_CLOSED_TRANSITION1:
-		if (lsmcu_ctx.lsmcu_zba_closed == 0) {
-			// Turn all lights off.
-			IL_SetState(0);
-			il_ctx.il_state = IL_STATE_OFF;
-		}
-		else {
-			if (TIM2_GetMs() > (il_ctx.il_switch_state_time + IL_ZBA_CLOSED_LSGR_DELAY_MS)) {
-				// Turn LSGR and LSBA on.
-				IL_SetState(0b001000011);
-				// Compute next state.
-				il_ctx.il_switch_state_time = TIM2_GetMs();
-				il_ctx.il_state = IL_STATE_ZBA_CLOSED_TRANSITION2;
-			}
-		}
-		break;
 	case IL_STATE_ZBA_CLOSED_TRANSITION2:
+		// Lights sequence is performed by timer callback.
 		if (lsmcu_ctx.lsmcu_zba_closed == 0) {
-			// Turn all lights off.
+			// Cancel sequence and turn all lights off.
+			TIMER_Stop(&(il_ctx.il_timer));
 			IL_SetState(0);
 			il_ctx.il_state = IL_STATE_OFF;
 		}
-		else {
-			if (TIM2_GetMs() > (il_ctx.il_switch_state_time + IL_ZBA_CLOSED_LSBA_BLINK_DURATION_MS)) {
-				// Turn LSBA off.
-				IL_SetState(0b000000011);
-				// Compute next state.
-				il_ctx.il_state = IL_STATE_ZBA_CLOSED;
-			}
-		}
 		break;
 	case IL_STATE_ZBA_CLOSED:
 		if (lsmcu_ctx.lsmcu_zba_closed == 0) {
@@ -205,54 +196,18 @@ void IL_Task(void) {
 			else {
 				if (lsmcu_ctx.lsmcu_dj_locked != 0) {
 					// Compute next state.
-					il_ctx.il_switch_state_time = TIM2_GetMs();
+					TIMER_Start(&(il_ctx.il_timer), IL_ZDJ_LOCKING_DURATION_MS);
 					il_ctx.il_state = IL_STATE_DJ_LOCKED_TRANSITION1;
 				}
 			}
 		}
 		break;
 	case IL_STATE_DJ_LOCKED_TRANSITION1:
-		// Wait for locking operation.
-		if (TIM2_GetMs() > (il_ctx.il_switch_state_time + IL_ZDJ_LOCKING_DURATION_MS)) {
-			// Turn LSPAT and LSCB off.
-			IL_SetState(0b000000011);
-			// Compute next state.
-			il_ctx.il_switch_state_time = TIM2_GetMs();
-			il_ctx.il_state = IL_STATE_DJ_LOCKED_TRANSITION2;
-		}
-		break;
 	case IL_STATE_DJ_LOCKED_TRANSITION2:
-		// Wait for LSDJ delay.
-		if (TIM2_GetMs() > (il_ctx.il_switch_state_time + IL_ZDJ_LOCKING_LSDJ_DELAY_MS)) {
-			// Turn LSDJ off.
-			IL_SetState(0b000000010);
-			// Compute next state.
-			il_ctx.il_state = IL_STATE_DJ_LOCKED;
-		}
+		// Wait for locking operation and LSDJ delay (performed by timer callback).
 		break;
 	case IL_STATE_DJ_LOCKED:
-		// Manage LSGR, LSS and LSP.
-		GPIO_Write(&GPIO_LSGR, (lsmcu_ctx.lsmcu_rheostat_0 != 0));
-		GPIO_Write(&GPIO_LSS, ((lsmcu_ctx.lsmcu_rheostat_0 == 0) && (lsmcu_ctx.lsmcu_series_traction != 0)));
-		GPIO_Write(&GPIO_LSP, ((lsmcu_ctx.lsmcu_rheostat_0 == 0) && (lsmcu_ctx.lsmcu_series_traction == 0)));
-		// Manage LSRH.
-		if (lsmcu_ctx.lsmcu_rheostat_0 == 0) {
-			if ((lsmcu_ctx.lsmcu_lsrh_blink_request != 0) && (GPIO_Read(&GPIO_LSRH) != 0)) {
-				GPIO_Write(&GPIO_LSRH, 0);
-				il_ctx.il_lsrh_blink_start_time = TIM2_GetMs();
-			}
-			else {
-				if (TIM2_GetMs() > (il_ctx.il_lsrh_blink_start_time + IL_LSRH_BLINK_DURATION_MS)) {
-					// End blink.
-					GPIO_Write(&GPIO_LSRH, 1);
-					// Reset flag.
-					lsmcu_ctx.lsmcu_lsrh_blink_request = 0;
-				}
-			}
-		}
-		else {
-			GPIO_Write(&GPIO_LSRH, 0);
-		}
+		// Traction lights are updated by IL_UpdateTractionLights on signal change.
 		// Check ZBA.
 		if (lsmcu_ctx.lsmcu_zba_closed == 0) {
 			// Turn all lights off.
@@ -274,3 +229,91 @@ void IL_Task(void) {
 		il_ctx.il_state = IL_STATE_OFF;
 	}
 }
+
+/* PERFORM TIMED TRANSITIONS OF IL STATE MACHINE (CALLED BY TIMER_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void IL_TimerCallback(void) {
+	switch (il_ctx.il_state) {
+	case IL_STATE_ZBA_CLOSED_TRANSITION1:
+		// Turn LSGR and LSBA on.
+		IL_SetState(0b001000011);
+		// Compute next state.
+		TIMER_Start(&(il_ctx.il_timer), IL_ZBA_CLOSED_LSBA_BLINK_DURATION_MS);
+		il_ctx.il_state = IL_STATE_ZBA_CLOSED_TRANSITION2;
+		break;
+	case IL_STATE_ZBA_CLOSED_TRANSITION2:
+		// Turn LSBA off.
+		IL_SetState(0b000000011);
+		// Compute next state.
+		il_ctx.il_state = IL_STATE_ZBA_CLOSED;
+		break;
+	case IL_STATE_DJ_LOCKED_TRANSITION1:
+		// Turn LSPAT and LSCB off.
+		IL_SetState(0b000000011);
+		// Compute next state.
+		TIMER_Start(&(il_ctx.il_timer), IL_ZDJ_LOCKING_LSDJ_DELAY_MS);
+		il_ctx.il_state = IL_STATE_DJ_LOCKED_TRANSITION2;
+		break;
+	case IL_STATE_DJ_LOCKED_TRANSITION2:
+		// Turn LSDJ off.
+		IL_SetState(0b000000010);
+		// Compute next state.
+		il_ctx.il_state = IL_STATE_DJ_LOCKED;
+		IL_UpdateTractionLights();
+		break;
+	default:
+		// No deadline in other states.
+		break;
+	}
+	// Signals may have changed during the sequence.
+	IL_Task();
+}
+
+/*** IL functions ***/
+
+/* INIT IL MODULE.
+ * @param:	None.
+ * @return:	None.
+ */
+void IL_Init(void) {
+	// Init GPIOs.
+	GPIO_Configure(&GPIO_LSDJ, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSGR, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSS, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSCB, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSP, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSPAT, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSBA, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSPI, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	GPIO_Configure(&GPIO_LSRH, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	// Init context.
+	il_ctx.il_state = IL_STATE_OFF;
+	TIMER_Register(&(il_ctx.il_timer), &IL_TimerCallback);
+	BLINK_Register(&(il_ctx.il_lsrh_blink), &GPIO_LSRH, IL_LSRH_BLINK_DURATION_MS, 0);
+	IL_SetState(0);
+	// Init global context.
+	lsmcu_ctx.lsmcu_lsrh_blink_request = 0;
+	// State machine and traction lights are only updated on change (series traction is constant, only set by MP_Init).
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_zba_closed), &IL_Task);
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_bl_unlocked), &IL_Task);
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_dj_closed), &IL_Task);
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_dj_locked), &IL_Task);
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_rheostat_0), &IL_UpdateTractionLights);
+	SIG_Subscribe(&(lsmcu_ctx.lsmcu_lsrh_blink_request), &IL_UpdateTractionLights);
+}
+
+/* MAIN TASK OF IL MODULE (CALLED ON SIGNAL CHANGE AND AFTER TIMED TRANSITIONS).
+ * @param:	None.
+ * @return:	None.
+ */
+void IL_Task(void) {
+	IL_State previous_state = il_ctx.il_state;
+	// Perform all transitions allowed by current signals (a polling task would have done one per pass).
+	IL_UpdateState();
+	while (il_ctx.il_state != previous_state) {
+		previous_state = il_ctx.il_state;
+		IL_UpdateState();
+	}
+}
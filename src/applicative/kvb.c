@@ -7,9 +7,13 @@
 
 #include "kvb.h"
 
+#include "blink.h"
 #include "common.h"
+#include "dma.h"
 #include "gpio.h"
 #include "mapping.h"
+#include "pwrm.h"
+#include "tcm.h"
 #include "tim.h"
 
 /*** KVB local macros ***/
@@ -17,14 +21,27 @@
 // KVB segments.
 #define KVB_NUMBER_OF_SEGMENTS 		8 		// 7 segments + dot.
 #define KVB_NUMBER_OF_DISPLAYS 		6 		// KVB has 6 displays (3 yellow and 3 green).
-#define KVB_DISPLAY_SWEEP_MS		2 		// Display sweep period in ms.
+// KVB sweep.
+#define KVB_REFRESH_RATE_MIN_HZ		20		// Minimum refresh rate (in Hz).
+#define KVB_REFRESH_RATE_MAX_HZ		500		// Maximum refresh rate (in Hz).
+#define KVB_SWEEP_DELAY_MIN_US		10		// Minimum sweep timer delay (in us), shorter phases are skipped.
+#define KVB_ASCII_TABLE_SIZE		128		// Number of characters in ASCII-to-7-segments table.
 // LVAL.
-#define KVB_LVAL_BLINK_PERIOD_MS	900		// Period of LVAL blinking (in ms).
+#define KVB_LVAL_BLINK_PERIOD_MS	900		// Default period of LVAL blinking (in ms).
+#define KVB_LVAL_TABLE_SIZE			100		// Number of duty cycle samples per LVAL blinking period.
+#define KVB_LVAL_PWM_FREQUENCY_HZ	4000	// TIM8 PWM frequency (1 DMA request can occur every PWM period).
 // LSSF.
-#define KVB_LSSF_BLINK_PERIOD_MS	333		// Period of LSSF blinking (in ms).
+#define KVB_LSSF_BLINK_OFF_MS		167		// Off duration of LSSF blinking (in ms).
+#define KVB_LSSF_BLINK_ON_MS		166		// On duration of LSSF blinking (in ms).
 
 /*** KVB local structures ***/
 
+// KVB sweep phase.
+typedef enum {
+	KVB_SWEEP_PHASE_ON,
+	KVB_SWEEP_PHASE_BLANK
+} KVB_SweepPhase;
+
 // KVB context.
 typedef struct KVB_Context {
 	unsigned char ascii_buf[KVB_NUMBER_OF_DISPLAYS];
@@ -33,158 +50,166 @@ typedef struct KVB_Context {
 	unsigned char segment_buf[KVB_NUMBER_OF_DISPLAYS];
 	unsigned char segment_idx; // A to dot.
 	unsigned char display_idx; // yel0 left to green right.
+	// Sweep timings.
+	KVB_SweepPhase sweep_phase;
+	unsigned int refresh_rate_hz;
+	unsigned int blanking_us;
+	unsigned char brightness_percent[KVB_NUMBER_OF_DISPLAYS];
+	unsigned int slot_us; // Time allocated to each display (on-time + off-time).
+	unsigned int on_us[KVB_NUMBER_OF_DISPLAYS];
+	unsigned int off_us[KVB_NUMBER_OF_DISPLAYS];
 	// Flags to enable LVAL and LSSF blinking.
 	unsigned char lval_blink_enable;
 	unsigned char lval_blinking;
+	unsigned int lval_blink_period_ms;
+	unsigned char lval_blink_phase_percent;
 	unsigned char lssf_blink_enable;
+	unsigned char lssf_blinking;
+	BLINK_Context lssf_blink;
 } KVB_Context;
 
 /*** KVB local global variables ***/
 
-static KVB_Context kvb_ctx;
+static KVB_Context kvb_ctx TCM_DTCM_DATA;
 static const GPIO* segment_gpio_buf[KVB_NUMBER_OF_SEGMENTS] = {&GPIO_KVB_ZSA, &GPIO_KVB_ZSB, &GPIO_KVB_ZSC, &GPIO_KVB_ZSD, &GPIO_KVB_ZSE, &GPIO_KVB_ZSF, &GPIO_KVB_ZSG, &GPIO_KVB_ZDOT};
 static const GPIO* display_gpio_buf[KVB_NUMBER_OF_DISPLAYS] = {&GPIO_KVB_ZJG, &GPIO_KVB_ZJC, &GPIO_KVB_ZJD, &GPIO_KVB_ZVG, &GPIO_KVB_ZVC, &GPIO_KVB_ZVD};
+// LVAL triangle wave (TIM8 CCR1 values for ARR=250) with gamma correction (2.2) for a linear perceived fade.
+static const unsigned int kvb_lval_duty_cycle_table[KVB_LVAL_TABLE_SIZE] = {
+	0, 0, 0, 1, 1, 2, 2, 3, 4, 6,
+	7, 9, 11, 13, 15, 18, 20, 23, 26, 30,
+	33, 37, 41, 45, 50, 54, 59, 64, 70, 75,
+	81, 87, 94, 100, 107, 114, 121, 129, 137, 145,
+	153, 162, 170, 179, 189, 198, 208, 218, 229, 239,
+	250, 239, 229, 218, 208, 198, 189, 179, 170, 162,
+	153, 145, 137, 129, 121, 114, 107, 100, 94, 87,
+	81, 75, 70, 64, 59, 54, 50, 45, 41, 37,
+	33, 30, 26, 23, 20, 18, 15, 13, 11, 9,
+	7, 6, 4, 3, 2, 2, 1, 1, 0, 0
+};
+// LVAL DMA buffer (table rotated according to start phase).
+static unsigned int kvb_lval_dma_buf[KVB_LVAL_TABLE_SIZE];
+// Segment configuration of each ASCII character, coded as <dot G F E D C B A> (0 = character can't be displayed).
+static const unsigned char kvb_ascii_to_7segments[KVB_ASCII_TABLE_SIZE] = {
+	// Symbols.
+	['-'] = 0b01000000,
+	['.'] = 0b10000000,
+	['_'] = 0b00001000,
+	['='] = 0b01001000,
+	['['] = 0b00111001,
+	[']'] = 0b00001111,
+	// Digits.
+	['0'] = 0b00111111,
+	['1'] = 0b00000110,
+	['2'] = 0b01011011,
+	['3'] = 0b01001111,
+	['4'] = 0b01100110,
+	['5'] = 0b01101101,
+	['6'] = 0b01111101,
+	['7'] = 0b00000111,
+	['8'] = 0b01111111,
+	['9'] = 0b01101111,
+	// Upper case letters.
+	['A'] = 0b01110111,
+	['C'] = 0b00111001,
+	['E'] = 0b01111001,
+	['F'] = 0b01110001,
+	['G'] = 0b00111101,
+	['H'] = 0b01110110,
+	['I'] = 0b00110000,
+	['J'] = 0b00001110,
+	['L'] = 0b00111000,
+	['O'] = 0b00111111,
+	['P'] = 0b01110011,
+	['S'] = 0b01101101,
+	['U'] = 0b00111110,
+	['Y'] = 0b01101110,
+	['Z'] = 0b01011011,
+	// Lower case letters.
+	['b'] = 0b01111100,
+	['c'] = 0b01011000,
+	['d'] = 0b01011110,
+	['e'] = 0b01111011,
+	['g'] = 0b01101111,
+	['h'] = 0b01110100,
+	['i'] = 0b00010000,
+	['l'] = 0b00110000,
+	['n'] = 0b01010100,
+	['o'] = 0b01011100,
+	['q'] = 0b01100111,
+	['r'] = 0b01010000,
+	['t'] = 0b01111000,
+	['u'] = 0b00011100,
+	['y'] = 0b01101110,
+};
 
 /*** KVB local functions ***/
 
 /* RETURNS THE SEGMENT CONFIGURATION TO DISPLAY A GIVEN ASCII CHARACTER.
  * @param ascii:	ASCII code of the input character.
- * @param segment:	The corresponding segment configuration, coded as <dot G F E D B C B A>.
+ * @param segment:	The corresponding segment configuration, coded as <dot G F E D C B A>.
  * 					0 (all segments off) if the input character is unknown or can't be displayed with 7 segments.
  */
 unsigned char KVB_AsciiTo7Segments(unsigned char ascii) {
 	unsigned char segment = 0;
-	switch (ascii) {
-	case 'b':
-		segment = 0b01111100;
-		break;
-	case 'c':
-		segment = 0b01011000;
-		break;
-	case 'd':
-		segment = 0b01011110;
-		break;
-	case 'h':
-		segment = 0b01110100;
-		break;
-	case 'n':
-		segment = 0b01010100;
-		break;
-	case 'o':
-		segment = 0b01011100;
-		break;
-	case 'r':
-		segment = 0b01010000;
-		break;
-	case 't':
-		segment = 0b01111000;
-		break;
-	case 'u':
-		segment = 0b00011100;
-		break;
-	case 'A':
-		segment = 0b01110111;
-		break;
-	case 'C':
-		segment = 0b00111001;
-		break;
-	case 'E':
-		segment = 0b01111001;
-		break;
-	case 'F':
-		segment = 0b01110001;
-		break;
-	case 'H':
-		segment = 0b01110110;
-		break;
-	case 'J':
-		segment = 0b00001110;
-		break;
-	case 'L':
-		segment = 0b00111000;
-		break;
-	case 'P':
-		segment = 0b01110011;
-		break;
-	case 'U':
-		segment = 0b00111110;
-		break;
-	case 'Y':
-		segment = 0b01101110;
-		break;
-	case '0':
-		segment = 0b00111111;
-		break;
-	case '1':
-		segment = 0b00000110;
-		break;
-	case '2':
-		segment = 0b01011011;
-		break;
-	case '3':
-		segment = 0b01001111;
-		break;
-	case '4':
-		segment = 0b01100110;
-		break;
-	case '5':
-		segment = 0b01101101;
-		break;
-	case '6':
-		segment = 0b01111101;
-		break;
-	case '7':
-		segment = 0b00000111;
-		break;
-	case '8':
-		segment = 0b01111111;
-		break;
-	case '9':
-		segment = 0b01101111;
-		break;
-	case '-':
-		segment = 0b01000000;
-		break;
-	default:
-		segment = 0;
-		break;
+	if (ascii < KVB_ASCII_TABLE_SIZE) {
+		segment = kvb_ascii_to_7segments[ascii];
 	}
 	return segment;
 }
 
-/* COMPUTE THE DUTY CYCLE TO MAKE LVAL BLINK.
+/* COMPUTE ON AND OFF TIMES OF EACH DISPLAY ACCORDING TO REFRESH RATE, BLANKING AND BRIGHTNESS.
  * @param:	None.
  * @return:	None.
  */
-void KVB_BlinkLVAL(void) {
-	// TBC: add time offset to start at 0%.
-	unsigned int t = TIM2_GetMs() % KVB_LVAL_BLINK_PERIOD_MS;
-	unsigned int lvalDutyCycle = 0;
-	// Triangle wave equation.
-	if (t <= (KVB_LVAL_BLINK_PERIOD_MS / 2)) {
-		lvalDutyCycle = (200 * t) / KVB_LVAL_BLINK_PERIOD_MS;
-	}
-	else {
-		lvalDutyCycle = 200 - ((200 * t) / KVB_LVAL_BLINK_PERIOD_MS);
+void KVB_ComputeSweepTimings(void) {
+	unsigned int idx = 0;
+	unsigned int on_us = 0;
+	// Time allocated to each display.
+	kvb_ctx.slot_us = 1000000 / ((kvb_ctx.refresh_rate_hz) * KVB_NUMBER_OF_DISPLAYS);
+	for (idx=0 ; idx<KVB_NUMBER_OF_DISPLAYS ; idx++) {
+		// Brightness is applied on the time remaining after blanking.
+		on_us = 0;
+		if (kvb_ctx.slot_us > kvb_ctx.blanking_us) {
+			on_us = ((kvb_ctx.slot_us - kvb_ctx.blanking_us) * kvb_ctx.brightness_percent[idx]) / 100;
+		}
+		if (on_us < KVB_SWEEP_DELAY_MIN_US) {
+			on_us = 0;
+		}
+		kvb_ctx.on_us[idx] = on_us;
+		kvb_ctx.off_us[idx] = kvb_ctx.slot_us - on_us;
 	}
-	// Set duty cycle.
-	TIM8_SetDutyCycle(lvalDutyCycle);
 }
 
-/* COMPUTE THE DUTY CYCLE TO MAKE LVAL BLINK.
+/* START LVAL BLINKING (DUTY CYCLE IS STREAMED INTO TIM8 BY DMA).
  * @param:	None.
  * @return:	None.
  */
-void KVB_BlinkLSSF(void) {
-	// TBC: add time offset to start at 0.
-	unsigned int t = TIM2_GetMs() % KVB_LSSF_BLINK_PERIOD_MS;
-	// Square wave equation.
-	if (t <= (KVB_LSSF_BLINK_PERIOD_MS / 2)) {
-		GPIO_Write(&GPIO_KVB_LSSF, 0);
-	}
-	else {
-		GPIO_Write(&GPIO_KVB_LSSF, 1);
+void KVB_StartBlinkLVAL(void) {
+	unsigned int idx = 0;
+	unsigned int start_idx = (kvb_ctx.lval_blink_phase_percent * KVB_LVAL_TABLE_SIZE) / 100;
+	// TIM8 is gated in standby.
+	PWRM_Wake();
+	// Fill DMA buffer according to start phase.
+	for (idx=0 ; idx<KVB_LVAL_TABLE_SIZE ; idx++) {
+		kvb_lval_dma_buf[idx] = kvb_lval_duty_cycle_table[(start_idx + idx) % KVB_LVAL_TABLE_SIZE];
 	}
+	// Set update rate to output the whole table in one blinking period.
+	TIM8_EnableUpdateDma(0);
+	TIM8_SetUpdatePeriods(((kvb_ctx.lval_blink_period_ms) * (KVB_LVAL_PWM_FREQUENCY_HZ / 1000)) / KVB_LVAL_TABLE_SIZE);
+	// Start DMA and timer.
+	DMA2_StartStream1(kvb_lval_dma_buf, KVB_LVAL_TABLE_SIZE);
+	TIM8_EnableUpdateDma(1);
+	TIM8_Start();
+}
+
+/* STOP LVAL BLINKING.
+ * @param:	None.
+ * @return:	None.
+ */
+void KVB_StopBlinkLVAL(void) {
+	TIM8_Stop();
+	TIM8_EnableUpdateDma(0);
+	DMA2_StopStream1();
 }
 
 /*** KVB functions ***/
@@ -207,9 +232,20 @@ void KVB_Init(void) {
 	}
 	kvb_ctx.display_idx = 0;
 	kvb_ctx.segment_idx = 0;
+	kvb_ctx.sweep_phase = KVB_SWEEP_PHASE_BLANK;
+	kvb_ctx.refresh_rate_hz = KVB_REFRESH_RATE_STANDARD_HZ;
+	kvb_ctx.blanking_us = KVB_BLANKING_STANDARD_US;
+	for (idx=0 ; idx<KVB_NUMBER_OF_DISPLAYS ; idx++) {
+		kvb_ctx.brightness_percent[idx] = 100;
+	}
+	KVB_ComputeSweepTimings();
 	kvb_ctx.lssf_blink_enable = 1;
+	kvb_ctx.lssf_blinking = 0;
+	BLINK_Register(&(kvb_ctx.lssf_blink), &GPIO_KVB_LSSF, KVB_LSSF_BLINK_OFF_MS, KVB_LSSF_BLINK_ON_MS);
 	kvb_ctx.lval_blink_enable = 0;
 	kvb_ctx.lval_blinking = 0;
+	kvb_ctx.lval_blink_period_ms = KVB_LVAL_BLINK_PERIOD_MS;
+	kvb_ctx.lval_blink_phase_percent = 0;
 	// Init global context.
 	lsmcu_ctx.lsmcu_urgency = 0;
 }
@@ -219,7 +255,11 @@ void KVB_Init(void) {
  * @return:	None.
  */
 void KVB_StartSweepTimer(void) {
-	// Start sweep timer.
+	// TIM6 is gated in standby.
+	PWRM_Wake();
+	// Start sweep timer (first interrupt will switch on the next display).
+	kvb_ctx.sweep_phase = KVB_SWEEP_PHASE_BLANK;
+	TIM6_SetDelayUs(kvb_ctx.slot_us);
 	TIM6_Start();
 }
 
@@ -230,6 +270,58 @@ void KVB_StartSweepTimer(void) {
 void KVB_StopSweepTimer(void) {
 	// Stop sweep timer.
 	TIM6_Stop();
+	// Switch off current display.
+	GPIO_Write(display_gpio_buf[kvb_ctx.display_idx], 0);
+}
+
+/* SET KVB PANEL REFRESH RATE.
+ * @param refresh_rate_hz:	Number of complete sweeps of the 6 displays per second.
+ * @return:					None.
+ */
+void KVB_SetRefreshRate(unsigned int refresh_rate_hz) {
+	// Clamp value.
+	unsigned int local_refresh_rate_hz = refresh_rate_hz;
+	if (local_refresh_rate_hz < KVB_REFRESH_RATE_MIN_HZ) {
+		local_refresh_rate_hz = KVB_REFRESH_RATE_MIN_HZ;
+	}
+	if (local_refresh_rate_hz > KVB_REFRESH_RATE_MAX_HZ) {
+		local_refresh_rate_hz = KVB_REFRESH_RATE_MAX_HZ;
+	}
+	kvb_ctx.refresh_rate_hz = local_refresh_rate_hz;
+	KVB_ComputeSweepTimings();
+}
+
+/* SET BLANKING INTERVAL INSERTED BETWEEN TWO DISPLAYS.
+ * @param blanking_us:	Duration during which all displays are off before switching to the next one (in us).
+ * @return:				None.
+ */
+void KVB_SetBlanking(unsigned int blanking_us) {
+	kvb_ctx.blanking_us = blanking_us;
+	KVB_ComputeSweepTimings();
+}
+
+/* SET THE BRIGHTNESS OF A KVB DISPLAY.
+ * @param display_idx:			Display index (0 to 2 for yellow displays, 3 to 5 for green displays).
+ * @param brightness_percent:	Display duty cycle in % (0 to 100).
+ * @return:						None.
+ */
+void KVB_SetBrightness(unsigned char display_idx, unsigned char brightness_percent) {
+	if (display_idx < KVB_NUMBER_OF_DISPLAYS) {
+		kvb_ctx.brightness_percent[display_idx] = (brightness_percent > 100) ? 100 : brightness_percent;
+		KVB_ComputeSweepTimings();
+	}
+}
+
+/* SET THE BRIGHTNESS OF ALL KVB DISPLAYS.
+ * @param brightness_percent:	Displays duty cycle in % (0 to 100).
+ * @return:						None.
+ */
+void KVB_SetBrightnessAll(unsigned char brightness_percent) {
+	unsigned char idx = 0;
+	for (idx=0 ; idx<KVB_NUMBER_OF_DISPLAYS ; idx++) {
+		kvb_ctx.brightness_percent[idx] = (brightness_percent > 100) ? 100 : brightness_percent;
+	}
+	KVB_ComputeSweepTimings();
 }
 
 /* FILL KVB ASCII BUFFER FOR FUTURE DISPLAYING.
@@ -282,34 +374,68 @@ void KVB_EnableBlinkLVAL(unsigned char blink_enabled) {
 	kvb_ctx.lval_blink_enable = blink_enabled;
 }
 
+/* CONFIGURE LVAL BLINKING.
+ * @param period_ms:		Blinking period in ms (multiple of 25ms, from 25 to 1638400).
+ * @param phase_percent:	Position in the period at which blinking starts, in % (0 = LVAL off, 50 = LVAL fully on).
+ * @return:					None.
+ */
+void KVB_ConfigureBlinkLVAL(unsigned int period_ms, unsigned char phase_percent) {
+	kvb_ctx.lval_blink_period_ms = period_ms;
+	kvb_ctx.lval_blink_phase_percent = phase_percent % 100;
+	// Apply new configuration immediately if LVAL is currently blinking.
+	if (kvb_ctx.lval_blinking != 0) {
+		KVB_StopBlinkLVAL();
+		KVB_StartBlinkLVAL();
+	}
+}
+
 /* ENABLE OR DISABLE LSSF BLINKING.
  * @param blinkEnabled:		New state.
  * @return:					None.
  */
 void KVB_EnableBlinkLSSF(unsigned char blink_enabled) {
 	kvb_ctx.lssf_blink_enable = blink_enabled;
+	// Stop immediately so that LSSF can be written by caller.
+	if ((blink_enabled == 0) && (kvb_ctx.lssf_blinking != 0)) {
+		BLINK_Stop(&(kvb_ctx.lssf_blink));
+		kvb_ctx.lssf_blinking = 0;
+	}
 }
 
-/* PROCESS KVB DISPLAY (CALLED BY TIM6 INTERRUPT HANDLER EVERY 2ms).
+/* PROCESS KVB DISPLAY (CALLED BY TIM6 INTERRUPT HANDLER AT THE END OF EACH ON OR BLANKING PHASE).
  * @param:	None.
  * @return:	None.
  */
-void KVB_Sweep(void) {
-	// Switch off previous display.
-	GPIO_Write(display_gpio_buf[kvb_ctx.display_idx], 0);
-	// Increment and manage index.
+void TCM_ITCM_FUNCTION KVB_Sweep(void) {
+	// End of on-time.
+	if (kvb_ctx.sweep_phase == KVB_SWEEP_PHASE_ON) {
+		// Switch off current display and start blanking.
+		GPIO_Write(display_gpio_buf[kvb_ctx.display_idx], 0);
+		kvb_ctx.sweep_phase = KVB_SWEEP_PHASE_BLANK;
+		if (kvb_ctx.off_us[kvb_ctx.display_idx] >= KVB_SWEEP_DELAY_MIN_US) {
+			TIM6_SetDelayUs(kvb_ctx.off_us[kvb_ctx.display_idx]);
+			return;
+		}
+	}
+	// End of blanking: increment and manage index.
 	kvb_ctx.display_idx++;
 	if (kvb_ctx.display_idx > (KVB_NUMBER_OF_DISPLAYS-1)) {
 		kvb_ctx.display_idx = 0;
 	}
-	// Process display only if a character is present.
-	if (kvb_ctx.segment_buf[kvb_ctx.display_idx] != 0) {
+	// Process display only if a character is present and brightness is not null.
+	if ((kvb_ctx.segment_buf[kvb_ctx.display_idx] != 0) && (kvb_ctx.on_us[kvb_ctx.display_idx] != 0)) {
 		// Switch on and off the segments of the current display.
 		for (kvb_ctx.segment_idx=0 ; kvb_ctx.segment_idx<KVB_NUMBER_OF_SEGMENTS ; kvb_ctx.segment_idx++) {
 			GPIO_Write(segment_gpio_buf[kvb_ctx.segment_idx], kvb_ctx.segment_buf[kvb_ctx.display_idx] & (0b1 << kvb_ctx.segment_idx));
 		}
 		// Finally switch on current display.
 		GPIO_Write(display_gpio_buf[kvb_ctx.display_idx], 1);
+		kvb_ctx.sweep_phase = KVB_SWEEP_PHASE_ON;
+		TIM6_SetDelayUs(kvb_ctx.on_us[kvb_ctx.display_idx]);
+	}
+	else {
+		// Display stays off during the whole slot.
+		TIM6_SetDelayUs(kvb_ctx.slot_us);
 	}
 }
 
@@ -321,17 +447,20 @@ void KVB_Task(void) {
 	// LVAL.
 	if (kvb_ctx.lval_blink_enable != 0) {
 		if (kvb_ctx.lval_blinking == 0) {
-			TIM8_Start();
+			KVB_StartBlinkLVAL();
 			kvb_ctx.lval_blinking = 1;
 		}
-		KVB_BlinkLVAL();
 	}
 	else {
-		TIM8_Stop();
-		kvb_ctx.lval_blinking = 0;
+		if (kvb_ctx.lval_blinking != 0) {
+			KVB_StopBlinkLVAL();
+			kvb_ctx.lval_blinking = 0;
+		}
 	}
 	// LSSF
-	if (kvb_ctx.lssf_blink_enable != 0) {
-		KVB_BlinkLSSF();
+	if ((kvb_ctx.lssf_blink_enable != 0) && (kvb_ctx.lssf_blinking == 0)) {
+		// Blinking is then performed by the blink engine.
+		BLINK_Start(&(kvb_ctx.lssf_blink), 0);
+		kvb_ctx.lssf_blinking = 1;
 	}
 }
@@ -8,10 +8,18 @@
 #include "lssgkcu.h"
 
 #include "common.h"
+#include "dwt.h"
+#include "hist.h"
 #include "kvb.h"
+#include "load.h"
 #include "gpio.h"
 #include "mapping.h"
+#include "pcs.h"
+#include "prof.h"
+#include "pwrm.h"
+#include "sig.h"
 #include "tch.h"
+#include "tcm.h"
 #include "usart.h"
 
 /*** LSSGKCU local macros ***/
@@ -22,13 +30,14 @@
 
 typedef struct {
 	unsigned char rx_buf[LSSGKCU_RX_BUFFER_SIZE];
-	unsigned int rx_write_idx;
+	unsigned int rx_cycles[LSSGKCU_RX_BUFFER_SIZE]; // Reception time of each byte (DWT cycles).
+	volatile unsigned int rx_write_idx; // Updated by USART interrupt.
 	unsigned int rx_read_idx;
 } LSSGKCU_Context;
 
 /*** LSSGKCU local global variables ***/
 
-static LSSGKCU_Context lssgkcu_ctx;
+static LSSGKCU_Context lssgkcu_ctx TCM_DTCM_DATA;
 
 /*** LSSGKCU local functions ***/
 
@@ -40,7 +49,7 @@ void LSSGKCU_Decode(void) {
 	unsigned char lssgkcu_command = lssgkcu_ctx.rx_buf[lssgkcu_ctx.rx_read_idx];
 	if (lssgkcu_command <= TCH_SPEED_MAX_KMH) {
 		// Save speed in main context.
-		lsmcu_ctx.lsmcu_speed_kmh = lssgkcu_command;
+		SIG_Write(&(lsmcu_ctx.lsmcu_speed_kmh), lssgkcu_command);
 	}
 	else {
 		// Decode LSSGKCU command.
@@ -144,6 +153,51 @@ void LSSGKCU_Decode(void) {
 		case LSMCU_IN_KVB_Y_000:
 			KVB_Display(KVB_Y_000);
 			break;
+		case LSMCU_IN_KVB_YG_DAY:
+			KVB_SetBrightnessAll(KVB_BRIGHTNESS_DAY_PERCENT);
+			break;
+		case LSMCU_IN_KVB_YG_NIGHT:
+			KVB_SetBrightnessAll(KVB_BRIGHTNESS_NIGHT_PERCENT);
+			break;
+#ifdef PROF_ENABLED
+		case LSMCU_IN_PROF_DUMP:
+			PROF_StartDump();
+			break;
+		case LSMCU_IN_PROF_RESET:
+			PROF_Reset();
+			break;
+#endif
+		case LSMCU_IN_HIST_DUMP:
+			HIST_StartDump();
+			break;
+		case LSMCU_IN_HIST_RESET:
+			HIST_Reset();
+			break;
+		case LSMCU_IN_LOAD_DUMP:
+			LOAD_Send();
+			break;
+#ifdef PCS_ENABLED
+		case LSMCU_IN_PCS_DUMP:
+			PCS_StartDump();
+			break;
+		case LSMCU_IN_PCS_RESET:
+			PCS_Reset();
+			break;
+#endif
+		case LSMCU_IN_SIG_DUMP:
+			SIG_Send();
+			break;
+		case LSMCU_IN_PWRM_DUMP:
+			PWRM_Send();
+			break;
+		case LSMCU_IN_KVB_YG_SWEEP_STANDARD:
+			KVB_SetRefreshRate(KVB_REFRESH_RATE_STANDARD_HZ);
+			KVB_SetBlanking(KVB_BLANKING_STANDARD_US);
+			break;
+		case LSMCU_IN_KVB_YG_SWEEP_CAMERA:
+			KVB_SetRefreshRate(KVB_REFRESH_RATE_CAMERA_HZ);
+			KVB_SetBlanking(KVB_BLANKING_CAMERA_US);
+			break;
 		default:
 			// Unknown command.
 			break;
@@ -169,8 +223,9 @@ void LSSGKCU_Init(void) {
  * @param lssgkcu_cmd:	The new LSSGKCU command to store.
  * @return:			None.
  */
-void LSSGKCU_FillRxBuffer(unsigned char lssgkcu_cmd) {
+void TCM_ITCM_FUNCTION LSSGKCU_FillRxBuffer(unsigned char lssgkcu_cmd) {
 	lssgkcu_ctx.rx_buf[lssgkcu_ctx.rx_write_idx] = lssgkcu_cmd;
+	lssgkcu_ctx.rx_cycles[lssgkcu_ctx.rx_write_idx] = DWT_GetCycleCount();
 	lssgkcu_ctx.rx_write_idx++;
 	// Roll-over management.
 	if (lssgkcu_ctx.rx_write_idx == LSSGKCU_RX_BUFFER_SIZE) {
@@ -191,8 +246,9 @@ void LSSGKCU_Send(unsigned char lssgkcu_cmd) {
  * @return:	None.
  */
 void LSSGKCU_Task(void) {
-	// LSSGKCU routine.
-	if (lssgkcu_ctx.rx_read_idx != lssgkcu_ctx.rx_write_idx) {
+	// Decode all received bytes (several bytes may have been received for a single event).
+	while (lssgkcu_ctx.rx_read_idx != lssgkcu_ctx.rx_write_idx) {
+		HIST_Add(HIST_ID_USART1_RX_LATENCY, DWT_GetCycleCount() - lssgkcu_ctx.rx_cycles[lssgkcu_ctx.rx_read_idx]);
 		LSSGKCU_Decode();
 		// Increment read index and manage roll-over.
 		lssgkcu_ctx.rx_read_idx++;
@@ -9,12 +9,69 @@
 
 #include "common.h"
 #include "mapping.h"
+#include "nvic.h"
+#include "pwr.h"
+#include "pwrm.h"
 #include "stepper.h"
+#include "tcm.h"
 #include "tim.h"
 
 /*** MANO local macros ***/
 
-#define MANO_STEP_IT_PERIOD_MAX		1000	// 1000 * 100s = 100ms.
+#define MANO_STEP_PERIOD_MAX_US		100000	// Step period at start and end of movement.
+#define MANOS_NUMBER_MAX			8		// Maximum number of manometers handled by step scheduler.
+// Needle model.
+#define MANOS_MODEL_PERIOD_MS				1		// Integration period.
+#define MANOS_MODEL_CATCH_UP_MAX			20		// Maximum number of integration steps per call (model time is resynchronized beyond).
+#define MANO_MODEL_FREQUENCY_DEFAULT_CENTIHZ	60		// Default needle natural frequency (0.6Hz).
+#define MANO_MODEL_DAMPING_DEFAULT_PERCENT		50		// Default needle damping ratio (0.5, slight overshoot).
+#ifdef MANO_MODEL_FPU
+#define MANO_MODEL_FROM_STEPS(x)			((MANO_ModelValue) (x))
+#define MANO_MODEL_TO_STEPS(x)				((int) ((x) + 0.5f))
+#define MANO_MODEL_DT						0.001f
+#define MANO_MODEL_POSITION_TOLERANCE		0.25f	// Settling position tolerance (in steps).
+#define MANO_MODEL_SPEED_TOLERANCE			1.0f	// Settling speed tolerance (in steps/s).
+#else
+#define MANO_MODEL_FROM_STEPS(x)			(((MANO_ModelValue) (x)) << 16)
+#define MANO_MODEL_TO_STEPS(x)				((int) (((x) + 32768) >> 16))
+#define MANO_MODEL_DT_Q32					4294967	// Integration period (1ms) in Q32, multiplying then shifting by 32 divides by 1000.
+#define MANO_MODEL_POSITION_TOLERANCE		16384	// Settling position tolerance (0.25 step in Q16).
+#define MANO_MODEL_SPEED_TOLERANCE			65536	// Settling speed tolerance (1 step/s in Q16).
+#define MANO_MODEL_TWO_PI_Q16				411775	// 2*pi in Q16.
+#endif
+#define MANOS_STEP_DELAY_MIN_US		10		// Minimum delay between two step interrupts.
+#define MANOS_STEP_DELAY_MAX_US		65535	// TIM7 is a 16-bits timer, longer delays are performed in several interrupts.
+// Power management.
+#define MANOS_POWER_HOLDOFF_MS		2000	// Drivers stay powered during this time after all needles stopped.
+// Position backup.
+#define MANOS_BACKUP_MAGIC			0x4D414E01	// "MAN" + layout version, stored in the first backup SRAM word.
+#define MANOS_BACKUP_MAGIC_IDX		0
+#define MANOS_BACKUP_SLOT_IDX		1			// First word of the slots (2 words per manometer: step and its complement).
+// Homing.
+#define MANO_HOMING_STEP_PERIOD_US	2000		// Step period used to reach mechanical stop.
+#define MANO_HOMING_MARGIN_PERCENT	10			// Additional distance to ensure the stop is reached from any position.
+
+/*** MANO local structures ***/
+
+// Drivers power state.
+typedef enum {
+	MANOS_POWER_STATE_OFF,
+	MANOS_POWER_STATE_ON,
+	MANOS_POWER_STATE_HOLDOFF
+} MANOS_PowerState;
+
+typedef struct {
+	MANO_Context* manos_list[MANOS_NUMBER_MAX];
+	unsigned char manos_count;
+	volatile unsigned int manos_step_delay_us; // Delay currently programmed in TIM7 (0 when timer is stopped).
+	unsigned int manos_model_time_ms; // Time of the last needle models integration.
+	MANOS_PowerState manos_power_state;
+	unsigned int manos_idle_start_time_ms;
+} MANOS_Context;
+
+/*** MANO local global variables ***/
+
+static MANOS_Context manos_ctx TCM_DTCM_DATA;
 
 /*** MANO local functions ***/
 
@@ -24,10 +81,11 @@
  */
 void MANOS_PowerOn(void) {
 	// Turn step motors on.
-	GPIO_Write(&GPIO_ZMANOS, 1);
-	GPIO_Write(&GPIO_LED_RED, 1);
-	// Start timer.
-	TIM7_Start();
+	if (manos_ctx.manos_power_state == MANOS_POWER_STATE_OFF) {
+		GPIO_Write(&GPIO_ZMANOS, 1);
+		GPIO_Write(&GPIO_LED_RED, 1);
+	}
+	manos_ctx.manos_power_state = MANOS_POWER_STATE_ON;
 }
 
 /* POWER MANOMETERS DRIVERS.
@@ -35,11 +93,239 @@ void MANOS_PowerOn(void) {
  * @return:	None.
  */
 void MANOS_PowerOff(void) {
-	// Turn step motors on.
+	// Turn step motors off.
 	GPIO_Write(&GPIO_ZMANOS, 0);
 	GPIO_Write(&GPIO_LED_RED, 0);
-	// Stop timer.
-	TIM7_Stop();
+	manos_ctx.manos_power_state = MANOS_POWER_STATE_OFF;
+}
+
+/* UPDATE ALL NEEDLES AND PROGRAM TIM7 ON THE NEAREST STEP.
+ * @param elapsed_us:	Time elapsed since previous call (in s).
+ * @return:				None.
+ */
+void TCM_ITCM_FUNCTION MANOS_ScheduleSteps(unsigned int elapsed_us) {
+	unsigned char idx = 0;
+	unsigned int remaining_us = 0;
+	unsigned int step_delay_us = 0;
+	// Perform due steps and search nearest next step (steppers sharing a port are written at once).
+	STEPPER_StartBatch();
+	for (idx=0 ; idx<manos_ctx.manos_count ; idx++) {
+		remaining_us = MANO_NeedleTask(manos_ctx.manos_list[idx], elapsed_us);
+		if ((remaining_us != 0) && ((step_delay_us == 0) || (remaining_us < step_delay_us))) {
+			step_delay_us = remaining_us;
+		}
+	}
+	STEPPER_EndBatch();
+	if (step_delay_us == 0) {
+		// All needles are stopped.
+		TIM7_Stop();
+	}
+	else {
+		// Program next interrupt.
+		if (step_delay_us < MANOS_STEP_DELAY_MIN_US) {
+			step_delay_us = MANOS_STEP_DELAY_MIN_US;
+		}
+		if (step_delay_us > MANOS_STEP_DELAY_MAX_US) {
+			step_delay_us = MANOS_STEP_DELAY_MAX_US;
+		}
+		TIM7_SetDelayUs(step_delay_us);
+		TIM7_ResetCounter();
+		TIM7_Start();
+	}
+	manos_ctx.manos_step_delay_us = step_delay_us;
+}
+
+/* TAKE A NEW TARGET INTO ACCOUNT WITHOUT WAITING FOR THE CURRENTLY PROGRAMMED STEP INTERRUPT.
+ * @param:	None.
+ * @return:	None.
+ */
+void MANOS_Kick(void) {
+	unsigned int elapsed_us = 0;
+	// TIM7 is gated in standby.
+	PWRM_Wake();
+	// Drivers must be powered before first step.
+	MANOS_PowerOn();
+	NVIC_DisableInterrupt(IT_TIM7);
+	// Nothing to do if interrupt is already pending, schedule will be updated by the handler.
+	if (TIM7_GetUifFlag() == 0) {
+		if (manos_ctx.manos_step_delay_us != 0) {
+			elapsed_us = TIM7_GetCounterUs();
+		}
+		MANOS_ScheduleSteps(elapsed_us);
+	}
+	NVIC_EnableInterrupt(IT_TIM7);
+}
+
+/* SAVE CURRENT NEEDLE POSITION IN BACKUP SRAM.
+ * @param mano:	Manometer to save.
+ * @return:		None.
+ */
+void MANO_SavePosition(MANO_Context* mano) {
+	unsigned int step = ((mano -> mano_stepper) -> stepper_current_step);
+	unsigned int word_idx = MANOS_BACKUP_SLOT_IDX + 2 * (mano -> mano_backup_idx);
+	PWR_WriteBackupSram(word_idx, step);
+	PWR_WriteBackupSram(word_idx + 1, ~step);
+}
+
+/* INVALIDATE NEEDLE POSITION IN BACKUP SRAM.
+ * @param mano:	Manometer to invalidate.
+ * @return:		None.
+ */
+void MANO_InvalidatePosition(MANO_Context* mano) {
+	unsigned int word_idx = MANOS_BACKUP_SLOT_IDX + 2 * (mano -> mano_backup_idx);
+	// Complement check fails.
+	PWR_WriteBackupSram(word_idx, 0);
+	PWR_WriteBackupSram(word_idx + 1, 0);
+}
+
+/* RESTORE NEEDLE POSITION FROM BACKUP SRAM.
+ * @param mano:		Manometer to restore.
+ * @return valid:	'1' if a valid position was restored, '0' otherwise.
+ */
+unsigned char MANO_RestorePosition(MANO_Context* mano) {
+	unsigned char valid = 0;
+	unsigned int word_idx = MANOS_BACKUP_SLOT_IDX + 2 * (mano -> mano_backup_idx);
+	unsigned int step = PWR_ReadBackupSram(word_idx);
+	// Check magic, complement and range.
+	if ((PWR_ReadBackupSram(MANOS_BACKUP_MAGIC_IDX) == MANOS_BACKUP_MAGIC) && (PWR_ReadBackupSram(word_idx + 1) == (~step))) {
+		if (step <= (mano -> mano_pressure_max_steps)) {
+			// Needle stays at its current position, coils are driven on its phase so that the rotor does not move when powered.
+			STEPPER_SetStep((mano -> mano_stepper), step);
+			mano -> mano_target_step = step;
+			(mano -> mano_model).model_target = MANO_MODEL_FROM_STEPS(step);
+			(mano -> mano_model).model_position = MANO_MODEL_FROM_STEPS(step);
+			(mano -> mano_model).model_speed = 0;
+			(mano -> mano_model).model_settled = 1;
+			valid = 1;
+		}
+	}
+	return valid;
+}
+
+/* START FAST HOMING: NEEDLE IS DRIVEN AGAINST ITS MECHANICAL STOP FROM BEYOND THE FULL SCALE.
+ * @param mano:	Manometer to home.
+ * @return:		None.
+ */
+void MANO_StartHoming(MANO_Context* mano) {
+	// Assume worst case position.
+	STEPPER_SetStep((mano -> mano_stepper), (mano -> mano_pressure_max_steps) + (((mano -> mano_pressure_max_steps) * MANO_HOMING_MARGIN_PERCENT) / 100));
+	mano -> mano_target_step = 0;
+	mano -> mano_step_period_us = MANO_HOMING_STEP_PERIOD_US;
+	mano -> mano_homing = 1;
+	// Position is unknown until homing completes, a reset during homing must restart it.
+	MANO_InvalidatePosition(mano);
+	// Needle model rests at zero.
+	(mano -> mano_model).model_target = 0;
+	(mano -> mano_model).model_position = 0;
+	(mano -> mano_model).model_speed = 0;
+	(mano -> mano_model).model_settled = 1;
+}
+
+/* COMPUTE NEEDLE MODEL COEFFICIENTS.
+ * @param mano:	Manometer to configure.
+ * @return:		None.
+ */
+void MANO_ComputeModelCoefficients(MANO_Context* mano) {
+	// Maximum speed (in steps per second) given by stepper minimum period.
+	unsigned int step_period_min_us = (mano -> mano_step_period_min_us);
+#ifdef MANO_MODEL_FPU
+	float omega = 6.2831853f * ((float) (mano -> mano_natural_frequency_centihz)) / 100.0f;
+	(mano -> mano_model).model_speed_max = 1000000.0f / ((float) step_period_min_us);
+	(mano -> mano_model).model_stiffness = omega * omega;
+	(mano -> mano_model).model_damping = (2.0f * omega * ((float) (mano -> mano_damping_ratio_percent))) / 100.0f;
+#else
+	MANO_ModelValue omega = (MANO_MODEL_TWO_PI_Q16 * ((MANO_ModelValue) (mano -> mano_natural_frequency_centihz))) / 100;
+	(mano -> mano_model).model_speed_max = (((MANO_ModelValue) 1000000) << 16) / step_period_min_us;
+	(mano -> mano_model).model_stiffness = (omega * omega) >> 16;
+	(mano -> mano_model).model_damping = (2 * omega * (mano -> mano_damping_ratio_percent)) / 100;
+#endif
+}
+
+/* INTEGRATE NEEDLE MODEL OVER ONE PERIOD (SEMI-IMPLICIT EULER).
+ * @param mano:	Manometer to update.
+ * @return:		None.
+ */
+void MANO_ModelStep(MANO_Context* mano) {
+	MANO_NeedleModel* model = &(mano -> mano_model);
+	MANO_ModelValue error = 0;
+	MANO_ModelValue acceleration = 0;
+	MANO_ModelValue position_max = MANO_MODEL_FROM_STEPS(mano -> mano_pressure_max_steps);
+	if ((model -> model_settled) == 0) {
+		// Spring and damper forces.
+		error = (model -> model_target) - (model -> model_position);
+#ifdef MANO_MODEL_FPU
+		acceleration = ((model -> model_stiffness) * error) - ((model -> model_damping) * (model -> model_speed));
+		(model -> model_speed) += acceleration * MANO_MODEL_DT;
+#else
+		acceleration = (((model -> model_stiffness) * error) >> 16) - (((model -> model_damping) * (model -> model_speed)) >> 16);
+		(model -> model_speed) += (acceleration * MANO_MODEL_DT_Q32) >> 32;
+#endif
+		// Speed is limited by stepper.
+		if ((model -> model_speed) > (model -> model_speed_max)) {
+			(model -> model_speed) = (model -> model_speed_max);
+		}
+		if ((model -> model_speed) < (-(model -> model_speed_max))) {
+			(model -> model_speed) = (-(model -> model_speed_max));
+		}
+#ifdef MANO_MODEL_FPU
+		(model -> model_position) += (model -> model_speed) * MANO_MODEL_DT;
+#else
+		(model -> model_position) += ((model -> model_speed) * MANO_MODEL_DT_Q32) >> 32;
+#endif
+		// Mechanical stops.
+		if ((model -> model_position) < 0) {
+			(model -> model_position) = 0;
+			(model -> model_speed) = 0;
+		}
+		if ((model -> model_position) > position_max) {
+			(model -> model_position) = position_max;
+			(model -> model_speed) = 0;
+		}
+		// Check if needle is settled.
+		error = (model -> model_target) - (model -> model_position);
+		if ((error < MANO_MODEL_POSITION_TOLERANCE) && (error > (-MANO_MODEL_POSITION_TOLERANCE)) &&
+			((model -> model_speed) < MANO_MODEL_SPEED_TOLERANCE) && ((model -> model_speed) > (-MANO_MODEL_SPEED_TOLERANCE))) {
+			(model -> model_position) = (model -> model_target);
+			(model -> model_speed) = 0;
+			(model -> model_settled) = 1;
+		}
+	}
+}
+
+/* UPDATE STEP SCHEDULER INPUTS FROM NEEDLE MODEL.
+ * @param mano:		Manometer to update.
+ * @return kick:	'1' if the step scheduler has to be kicked (needle stopped and new target), '0' otherwise.
+ */
+unsigned char MANO_ModelOutput(MANO_Context* mano) {
+	unsigned char kick = 0;
+	int target_step = MANO_MODEL_TO_STEPS((mano -> mano_model).model_position);
+	MANO_ModelValue speed = (mano -> mano_model).model_speed;
+	unsigned int step_period_us = MANO_STEP_PERIOD_MAX_US;
+	// Step period from model speed.
+	if (speed < 0) {
+		speed = (-speed);
+	}
+	if (speed != 0) {
+#ifdef MANO_MODEL_FPU
+		float period = 1000000.0f / speed;
+		step_period_us = (period < ((float) MANO_STEP_PERIOD_MAX_US)) ? ((unsigned int) period) : MANO_STEP_PERIOD_MAX_US;
+#else
+		MANO_ModelValue period = (((MANO_ModelValue) 1000000) << 16) / speed;
+		step_period_us = (period < MANO_STEP_PERIOD_MAX_US) ? ((unsigned int) period) : MANO_STEP_PERIOD_MAX_US;
+#endif
+	}
+	mano -> mano_step_period_us = step_period_us;
+	// Update scheduler target.
+	if (target_step < 0) {
+		target_step = 0;
+	}
+	if (((unsigned int) target_step) != (mano -> mano_target_step)) {
+		mano -> mano_target_step = target_step;
+		if ((mano -> mano_step_remaining_us) == 0) {
+			kick = 1;
+		}
+	}
+	return kick;
 }
 
 /* CHECK IF A GIVEN NEEDLE IS MOVING.
@@ -48,7 +334,7 @@ void MANOS_PowerOff(void) {
  */
 unsigned char MANO_NeedleIsMoving(MANO_Context* mano) {
 	unsigned char moving = 0;
-	if (((mano -> mano_stepper) -> stepper_current_step) != (mano -> mano_target_step)) {
+	if ((((mano -> mano_stepper) -> stepper_current_step) != (mano -> mano_target_step)) || ((mano -> mano_model).model_settled == 0)) {
 		moving = 1;
 	}
 	return moving;
@@ -63,6 +349,14 @@ unsigned char MANO_NeedleIsMoving(MANO_Context* mano) {
 void MANOS_Init(void) {
 	// Init GPIOs.
 	GPIO_Configure(&GPIO_ZMANOS, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	// Init context.
+	manos_ctx.manos_idle_start_time_ms = 0;
+	MANOS_PowerOff();
+	manos_ctx.manos_count = 0;
+	manos_ctx.manos_step_delay_us = 0;
+	manos_ctx.manos_model_time_ms = TIM2_GetMs();
+	// Needle positions are persisted in backup SRAM.
+	PWR_EnableBackupSram();
 }
 
 /* CONTROL ZMANOS SIGNAL.
@@ -70,21 +364,98 @@ void MANOS_Init(void) {
  * @return:	None.
  */
 void MANOS_ManagePower(void) {
+	unsigned char idx = 0;
+	unsigned char moving = 0;
 	// Check all manometers.
-	if ((MANO_NeedleIsMoving(&lsmcu_ctx.lsmcu_mano_cp) == 0) &&
-		(MANO_NeedleIsMoving(&lsmcu_ctx.lsmcu_mano_re) == 0) &&
-		(MANO_NeedleIsMoving(&lsmcu_ctx.lsmcu_mano_cg) == 0) &&
-		(MANO_NeedleIsMoving(&lsmcu_ctx.lsmcu_mano_cf1) == 0) &&
-		(MANO_NeedleIsMoving(&lsmcu_ctx.lsmcu_mano_cf2) == 0)) {
-		// Turn manometers off.
+	for (idx=0 ; idx<manos_ctx.manos_count ; idx++) {
+		moving |= MANO_NeedleIsMoving(manos_ctx.manos_list[idx]);
+	}
+	// Perform state machine.
+	switch (manos_ctx.manos_power_state) {
+	case MANOS_POWER_STATE_OFF:
+		if (moving != 0) {
+			// Turn manometers on.
+			MANOS_PowerOn();
+		}
+		break;
+	case MANOS_POWER_STATE_ON:
+		if (moving == 0) {
+			// Start hold-off.
+			manos_ctx.manos_idle_start_time_ms = TIM2_GetMs();
+			manos_ctx.manos_power_state = MANOS_POWER_STATE_HOLDOFF;
+		}
+		break;
+	case MANOS_POWER_STATE_HOLDOFF:
+		if (moving != 0) {
+			// New movement during hold-off: drivers are still on.
+			manos_ctx.manos_power_state = MANOS_POWER_STATE_ON;
+		}
+		else {
+			if ((TIM2_GetMs() - manos_ctx.manos_idle_start_time_ms) >= MANOS_POWER_HOLDOFF_MS) {
+				// Turn manometers off.
+				MANOS_PowerOff();
+			}
+		}
+		break;
+	default:
 		MANOS_PowerOff();
+		break;
 	}
-	else {
-		// Turn manometers on.
-		MANOS_PowerOn();
+}
+
+/* INTEGRATE NEEDLE MODELS AT FIXED RATE AND FEED STEP SCHEDULER.
+ * @param:	None.
+ * @return:	None.
+ */
+void MANOS_Task(void) {
+	unsigned char idx = 0;
+	unsigned char iteration_count = 0;
+	unsigned char kick = 0;
+	unsigned int now_ms = TIM2_GetMs();
+	// Catch up missed periods.
+	while (((int) (now_ms - manos_ctx.manos_model_time_ms)) >= MANOS_MODEL_PERIOD_MS) {
+		for (idx=0 ; idx<manos_ctx.manos_count ; idx++) {
+			MANO_ModelStep(manos_ctx.manos_list[idx]);
+		}
+		manos_ctx.manos_model_time_ms += MANOS_MODEL_PERIOD_MS;
+		iteration_count++;
+		// Resynchronize model time if main loop was blocked too long.
+		if (iteration_count >= MANOS_MODEL_CATCH_UP_MAX) {
+			manos_ctx.manos_model_time_ms = now_ms;
+			break;
+		}
+	}
+	// Update step scheduler.
+	if (iteration_count != 0) {
+		for (idx=0 ; idx<manos_ctx.manos_count ; idx++) {
+			// Model is not used during homing.
+			if ((manos_ctx.manos_list[idx] -> mano_homing) != 0) {
+				if (((manos_ctx.manos_list[idx] -> mano_stepper) -> stepper_current_step) == 0) {
+					manos_ctx.manos_list[idx] -> mano_homing = 0;
+					// Backup data is valid from now.
+					MANO_SavePosition(manos_ctx.manos_list[idx]);
+					PWR_WriteBackupSram(MANOS_BACKUP_MAGIC_IDX, MANOS_BACKUP_MAGIC);
+				}
+			}
+			else {
+				kick |= MANO_ModelOutput(manos_ctx.manos_list[idx]);
+			}
+		}
+		if (kick != 0) {
+			MANOS_Kick();
+		}
 	}
 }
 
+/* PERFORM DUE NEEDLE STEPS (CALLED BY TIM7 INTERRUPT HANDLER).
+ * @param:	None.
+ * @return:	None.
+ */
+void TCM_ITCM_FUNCTION MANOS_StepScheduler(void) {
+	// Elapsed time is the programmed delay plus the interrupt latency.
+	MANOS_ScheduleSteps((manos_ctx.manos_step_delay_us) + TIM7_GetCounterUs());
+}
+
 /* INIT MANOMETER.
  * @param mano:						Manometer to configure.
  * @param stepper:					Step motor attached to the needle.
@@ -92,129 +463,119 @@ void MANOS_ManagePower(void) {
  * @param stepper_cmd2:				Step motor GPIO2.
  * @param pressure_max_decibars:	Maximum pressure displayed on the manometers (in decibars).
  * @param pressure_max_steps:		Number of motor steps required to reach the maximum pressure.
- * @param needle_inertia_steps:		Number of steps used to perform needle inertia.
  * @param needle_speed_max:			Minimum step IT period (expressed in hundreds of s).
  * @return:							None.
  */
-void MANO_Init(MANO_Context* mano, STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2, unsigned int pressure_max_decibars, unsigned int pressure_max_steps, unsigned int needle_inertia_steps, unsigned int needle_speed_max) {
+void MANO_Init(MANO_Context* mano, STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2, unsigned int pressure_max_decibars, unsigned int pressure_max_steps, unsigned int needle_speed_max) {
 	// Init GPIOs.
 	STEPPER_Init(stepper, stepper_cmd1, stepper_cmd2);
 	// Init context.
 	mano -> mano_pressure_max_decibars = pressure_max_decibars;
 	mano -> mano_pressure_max_steps = pressure_max_steps;
-	mano -> mano_needle_inertia_steps = needle_inertia_steps;
-	mano -> mano_enable = 0;
 	mano -> mano_stepper = stepper;
-	mano -> mano_start_step = 0;
 	mano -> mano_target_step = 0;
-	mano -> mano_step_it_count = 0;
-	mano -> mano_step_it_period = 0;
-	mano -> mano_step_it_period_min = needle_speed_max;
-}
-
-/* UPDATE PRESSURE TARGET.
- * @param mano:					Manometer to control.
- * @param pressure_decibars:	New pressure expressed in decibars.
- */
-void MANO_SetTarget(MANO_Context* mano, unsigned int pressure_decibars) {
-	// Update target step.
-	mano -> mano_target_step = ((mano -> mano_pressure_max_steps) * pressure_decibars) / (mano -> mano_pressure_max_decibars);
+	mano -> mano_step_remaining_us = 0;
+	mano -> mano_step_period_us = MANO_STEP_PERIOD_MAX_US;
+	mano -> mano_step_period_min_us = (needle_speed_max * 100);
+	// Init needle model.
+	(mano -> mano_model).model_target = 0;
+	(mano -> mano_model).model_position = 0;
+	(mano -> mano_model).model_speed = 0;
+	(mano -> mano_model).model_settled = 1;
+	MANO_SetNeedleDynamics(mano, MANO_MODEL_FREQUENCY_DEFAULT_CENTIHZ, MANO_MODEL_DAMPING_DEFAULT_PERCENT);
+	mano -> mano_homing = 0;
+	// Register manometer in step scheduler.
+	if (manos_ctx.manos_count < MANOS_NUMBER_MAX) {
+		manos_ctx.manos_list[manos_ctx.manos_count] = mano;
+		mano -> mano_backup_idx = manos_ctx.manos_count;
+		manos_ctx.manos_count++;
+	}
+	// Restore last position or perform homing (backup data is validated at the end of homing).
+	if (MANO_RestorePosition(mano) == 0) {
+		MANO_StartHoming(mano);
+		MANOS_Kick();
+	}
 }
 
-/* GET CURRENT MANOMETER PRESSURE.
- * @param mano:					Manometer to analyse.
- * @return pressure_decibars:	Current pressure displayed by the manometer in decibars.
+/* SET NEEDLE DYNAMICS.
+ * @param mano:							Manometer to configure.
+ * @param natural_frequency_centihz:	Natural frequency of the needle (in hundredths of Hz).
+ * @param damping_ratio_percent:		Damping ratio in % (100 = critical damping, lower values give overshoot).
+ * @return:								None.
  */
-unsigned int MANO_GetPressure(MANO_Context* mano) {
-	unsigned int pressure_decibars = (((mano -> mano_stepper) -> stepper_current_step) * (mano -> mano_pressure_max_decibars)) / (mano -> mano_pressure_max_steps);
-	return pressure_decibars;
+void MANO_SetNeedleDynamics(MANO_Context* mano, unsigned int natural_frequency_centihz, unsigned int damping_ratio_percent) {
+	mano -> mano_natural_frequency_centihz = natural_frequency_centihz;
+	mano -> mano_damping_ratio_percent = damping_ratio_percent;
+	MANO_ComputeModelCoefficients(mano);
 }
 
-/* START NEEDLE MOVEMENT.
- * @param mano:	Manometer to control.
- * @return:		None.
+/* UPDATE PRESSURE TARGET WITH MILLIBAR RESOLUTION.
+ * @param mano:					Manometer to control.
+ * @param pressure_millibars:	New pressure expressed in millibars.
  */
-void MANO_StartNeedle(MANO_Context* mano) {
-	// Enable movement.
-	mano -> mano_enable = 1;
-	// Store current position as start step.
-	mano -> mano_start_step = (mano -> mano_stepper -> stepper_current_step);
+void MANO_SetTargetMillibars(MANO_Context* mano, unsigned int pressure_millibars) {
+	// Update target step.
+	unsigned int target_step = ((mano -> mano_pressure_max_steps) * pressure_millibars) / ((mano -> mano_pressure_max_decibars) * 100);
+	if (target_step > (mano -> mano_pressure_max_steps)) {
+		target_step = (mano -> mano_pressure_max_steps);
+	}
+	// Update needle model rest position.
+	if (MANO_MODEL_FROM_STEPS(target_step) != (mano -> mano_model).model_target) {
+		(mano -> mano_model).model_target = MANO_MODEL_FROM_STEPS(target_step);
+		(mano -> mano_model).model_settled = 0;
+	}
 }
 
-/* STOP NEEDLE MOVEMENT.
- * @param mano:	Manometer to control.
- * @return:		None.
+/* GET CURRENT MANOMETER PRESSURE WITH MILLIBAR RESOLUTION.
+ * @param mano:					Manometer to analyse.
+ * @return pressure_millibars:	Current pressure displayed by the manometer in millibars (0 during homing).
  */
-void MANO_StopNeedle(MANO_Context* mano) {
-	// Disable movement.
-	mano -> mano_enable = 0;
-	// Update target to perform inertia.
-	// Up direction.
-	if (((mano -> mano_stepper) -> stepper_current_step) < (mano -> mano_target_step)) {
-		// Current step < (max - inertia)
-		if (((mano -> mano_stepper) -> stepper_current_step) < ((mano -> mano_pressure_max_steps) - (mano -> mano_needle_inertia_steps))) {
-			// New target = current + inertia.
-			mano -> mano_target_step = ((mano -> mano_stepper) -> stepper_current_step) + (mano -> mano_needle_inertia_steps);
-		}
-	}
-	// Down direction.
-	if (((mano -> mano_stepper) -> stepper_current_step) > (mano -> mano_target_step)) {
-		// Current step > (0 + inertia).
-		if (((mano -> mano_stepper) -> stepper_current_step) > (mano -> mano_needle_inertia_steps)) {
-			// New target = current - inertia.
-			mano -> mano_target_step = ((mano -> mano_stepper) -> stepper_current_step) - (mano -> mano_needle_inertia_steps);
-		}
+unsigned int MANO_GetPressureMillibars(MANO_Context* mano) {
+	unsigned int pressure_millibars = 0;
+	// Position is unknown during homing.
+	if ((mano -> mano_homing) == 0) {
+		pressure_millibars = (((mano -> mano_stepper) -> stepper_current_step) * (mano -> mano_pressure_max_decibars) * 100) / (mano -> mano_pressure_max_steps);
 	}
+	return pressure_millibars;
 }
 
-/* MANOMETER MAIN TASK (CALLED BY TIM7 INTERRUPT HANDLER EVERY 100s).
- * @param:	None.
- * @return:	None.
+/* MANOMETER NEEDLE CONTROL (CALLED BY STEP SCHEDULER).
+ * @param mano:			Manometer to control.
+ * @param elapsed_us:	Time elapsed since previous call (in s).
+ * @return:				Time before next step in s, 0 if the needle is stopped.
  */
-void MANO_NeedleTask(MANO_Context* mano) {
-	// Movement feedback loop.
-	mano -> mano_step_it_count++;
+unsigned int TCM_ITCM_FUNCTION MANO_NeedleTask(MANO_Context* mano, unsigned int elapsed_us) {
 	unsigned int current_step = ((mano -> mano_stepper) -> stepper_current_step);
-	// ChecK if the period was reached.
-	if ((mano -> mano_step_it_count) >= (mano -> mano_step_it_period)) {
-		// Reset interrupt count.
-		mano -> mano_step_it_count = 0;
-		// Up direction.
-		if (current_step < (mano -> mano_target_step)) {
-			STEPPER_Up(mano -> mano_stepper);
-		}
-		// Down direction.
-		if (current_step > (mano -> mano_target_step)) {
-			STEPPER_Down(mano -> mano_stepper);
-		}
-	}
-	// Compute next period.
-	if (current_step != (mano -> mano_target_step)) {
-		// Get absolute distances between start, target and current steps.
-		unsigned int delta_start = 0;
-		unsigned int delta_target = 0;
-		// Up direction.
-		if (current_step < (mano -> mano_target_step)) {
-			delta_start = current_step - (mano -> mano_start_step);
-			delta_target = (mano -> mano_target_step) - current_step;
-		}
-		// Down direction.
-		if (current_step > (mano -> mano_target_step)) {
-			delta_start = (mano -> mano_start_step) - current_step;
-			delta_target = current_step - (mano -> mano_target_step);
-		}
-		// Perform linear equation.
-		if (delta_start < (mano -> mano_needle_inertia_steps)) {
-			mano -> mano_step_it_period = MANO_STEP_IT_PERIOD_MAX - ((MANO_STEP_IT_PERIOD_MAX - (mano -> mano_step_it_period_min)) * (delta_start)) / (mano -> mano_needle_inertia_steps);
+	// Check if target is reached.
+	if (current_step == (mano -> mano_target_step)) {
+		mano -> mano_step_remaining_us = 0;
+	}
+	else {
+		// Check if the period was reached.
+		if ((mano -> mano_step_remaining_us) > elapsed_us) {
+			mano -> mano_step_remaining_us -= elapsed_us;
 		}
 		else {
-			if (delta_target < (mano -> mano_needle_inertia_steps)) {
-				mano -> mano_step_it_period = MANO_STEP_IT_PERIOD_MAX - ((MANO_STEP_IT_PERIOD_MAX - (mano -> mano_step_it_period_min)) * (delta_target)) / (mano -> mano_needle_inertia_steps);
+			// Up direction.
+			if (current_step < (mano -> mano_target_step)) {
+				STEPPER_Up(mano -> mano_stepper);
+			}
+			// Down direction.
+			else {
+				STEPPER_Down(mano -> mano_stepper);
+			}
+			// Persist new position (unknown during homing).
+			if ((mano -> mano_homing) == 0) {
+				MANO_SavePosition(mano);
+			}
+			// Next step period is given by needle model speed.
+			if (((mano -> mano_stepper) -> stepper_current_step) == (mano -> mano_target_step)) {
+				mano -> mano_step_remaining_us = 0;
 			}
 			else {
-				// Maximum speed.
-				mano -> mano_step_it_period = (mano -> mano_step_it_period_min);
+				mano -> mano_step_remaining_us = (mano -> mano_step_period_us);
 			}
 		}
 	}
+	return (mano -> mano_step_remaining_us);
 }
@@ -11,8 +11,9 @@
 #include "gpio.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw2.h"
-#include "tim.h"
+#include "timer.h"
 #include "usart.h"
 
 /*** MP local macros ***/
@@ -20,6 +21,11 @@
 #define MP_T_MORE_PERIOD_MS		500
 #define MP_T_LESS_PERIOD_MS		350
 #define MP_GEAR_MAX				16
+// A switch was allowed one period of its direction after the previous switch time plus the period of the previous direction.
+#define MP_T_MORE_AFTER_MORE_MS	(MP_T_MORE_PERIOD_MS + MP_T_MORE_PERIOD_MS)
+#define MP_T_LESS_AFTER_MORE_MS	(MP_T_MORE_PERIOD_MS + MP_T_LESS_PERIOD_MS)
+#define MP_T_LESS_AFTER_LESS_MS	(MP_T_LESS_PERIOD_MS + MP_T_LESS_PERIOD_MS)
+#define MP_T_MORE_AFTER_LESS_MS	(MP_T_LESS_PERIOD_MS + MP_T_MORE_PERIOD_MS)
 
 /*** MP local structures ***/
 
@@ -43,7 +49,8 @@ typedef struct {
 	unsigned char mp_tr_on;
 	// Rheostat management.
 	unsigned char mp_gear_count;
-	unsigned long mp_gear_switch_next_time;
+	TIMER_Context mp_gear_more_timer; // Running while next gear increase is not allowed.
+	TIMER_Context mp_gear_less_timer; // Running while next gear decrease is not allowed.
 } MP_Context;
 
 /*** MP local global variables ***/
@@ -61,7 +68,7 @@ void MP_IncreaseGear(void) {
 	if (mp_ctx.mp_gear_count < MP_GEAR_MAX) {
 		// Increment gear and send command.
 		mp_ctx.mp_gear_count++;
-		lsmcu_ctx.lsmcu_lsrh_blink_request = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_lsrh_blink_request), 1);
 		LSSGKCU_Send(LSMCU_OUT_MP_T_MORE);
 	}
 }
@@ -75,7 +82,7 @@ void MP_DecreaseGear(void) {
 	if (mp_ctx.mp_gear_count > 0) {
 		// Decrement gear and send command.
 		mp_ctx.mp_gear_count--;
-		lsmcu_ctx.lsmcu_lsrh_blink_request = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_lsrh_blink_request), 1);
 		LSSGKCU_Send(LSMCU_OUT_MP_T_LESS);
 	}
 }
@@ -107,7 +114,8 @@ void MP_Init(void) {
 	GPIO_Configure(&GPIO_MP_SH_ENABLE, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	// Init context.
 	mp_ctx.mp_gear_count = 0;
-	mp_ctx.mp_gear_switch_next_time = 0;
+	TIMER_Register(&mp_ctx.mp_gear_more_timer, 0);
+	TIMER_Register(&mp_ctx.mp_gear_less_timer, 0);
 	// Init global context.
 	lsmcu_ctx.lsmcu_rheostat_0 = 1;
 	lsmcu_ctx.lsmcu_series_traction = 1;
@@ -119,18 +127,19 @@ void MP_Init(void) {
  */
 void MP_Task(void) {
 	// Update global context.
-	lsmcu_ctx.lsmcu_rheostat_0 = (mp_ctx.mp_gear_count == 0) ? 1 : 0;
+	SIG_Write(&(lsmcu_ctx.lsmcu_rheostat_0), (mp_ctx.mp_gear_count == 0) ? 1 : 0);
 	// MP.0.
 	SW2_UpdateState(&mp_ctx.mp_0);
 	if (mp_ctx.mp_0.sw2_state == SW2_ON) {
 		// Decrease gear count until 0.
-		if ((mp_ctx.mp_gear_count > 0) && (TIM2_GetMs() > (mp_ctx.mp_gear_switch_next_time + MP_T_LESS_PERIOD_MS))) {
+		if ((mp_ctx.mp_gear_count > 0) && (TIMER_IsRunning(&mp_ctx.mp_gear_less_timer) == 0)) {
 			MP_DecreaseGear();
 			//if (mp_ctx.mp_gear_count == 0) {
 				//LSSGKCU_Send(LSMCU_OUT_MP_0);
 			//}
-			// Update next time.
-			mp_ctx.mp_gear_switch_next_time = TIM2_GetMs() + MP_T_LESS_PERIOD_MS;
+			// Lock next switches.
+			TIMER_Start(&mp_ctx.mp_gear_less_timer, MP_T_LESS_AFTER_LESS_MS);
+			TIMER_Start(&mp_ctx.mp_gear_more_timer, MP_T_MORE_AFTER_LESS_MS);
 		}
 	}
 	// MP.T+.
@@ -161,10 +170,11 @@ void MP_Task(void) {
 	SW2_UpdateState(&mp_ctx.mp_pr);
 	if (mp_ctx.mp_pr.sw2_state == SW2_ON) {
 		// Increase gear count until maximum.
-		if ((mp_ctx.mp_gear_count < MP_GEAR_MAX) && (TIM2_GetMs() > (mp_ctx.mp_gear_switch_next_time + MP_T_MORE_PERIOD_MS))) {
+		if ((mp_ctx.mp_gear_count < MP_GEAR_MAX) && (TIMER_IsRunning(&mp_ctx.mp_gear_more_timer) == 0)) {
 			MP_IncreaseGear();
-			// Update next time.
-			mp_ctx.mp_gear_switch_next_time = TIM2_GetMs() + MP_T_MORE_PERIOD_MS;
+			// Lock next switches.
+			TIMER_Start(&mp_ctx.mp_gear_more_timer, MP_T_MORE_AFTER_MORE_MS);
+			TIMER_Start(&mp_ctx.mp_gear_less_timer, MP_T_LESS_AFTER_MORE_MS);
 		}
 	}
 }
@@ -11,13 +11,13 @@
 #include "gpio.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "pneu.h"
+#include "sig.h"
 #include "sw4.h"
 
 /*** PBL2 local macros ***/
 
-#define PBL2_MIN_CP_PRESSURE_DECIBARS	50
-#define PBL2_ON_CG_PRESSURE_DECIBARS	35
-#define PBL2_ON_RE_PRESSURE_DECIBARS	35
+#define PBL2_MIN_CP_PRESSURE_MILLIBARS	5000
 
 /*** PBL2 local global variables ***/
 
@@ -58,13 +58,8 @@ void PBL2_Task(void) {
 		if (lsmcu_ctx.lsmcu_pbl2_on != 0) {
 			// Send command on change.
 			LSSGKCU_Send(LSMCU_OUT_FPB_OFF);
-			// Empty CG and RE.
-			MANO_SetTarget(&lsmcu_ctx.lsmcu_mano_cg, 0);
-			MANO_StartNeedle(&lsmcu_ctx.lsmcu_mano_cg);
-			MANO_SetTarget(&lsmcu_ctx.lsmcu_mano_re, 0);
-			MANO_StartNeedle(&lsmcu_ctx.lsmcu_mano_re);
-			// Update global context.
-			lsmcu_ctx.lsmcu_pbl2_on = 0;
+			// Update global context (CG and RE are vented by pneumatic model).
+			SIG_Write(&(lsmcu_ctx.lsmcu_pbl2_on), 0);
 		}
 		break;
 	case SW4_P1:
@@ -72,16 +67,11 @@ void PBL2_Task(void) {
 		break;
 	case SW4_P2:
 		// Service.
-		if ((lsmcu_ctx.lsmcu_pbl2_on == 0) && (MANO_GetPressure(&lsmcu_ctx.lsmcu_mano_cp) > PBL2_MIN_CP_PRESSURE_DECIBARS)) {
+		if ((lsmcu_ctx.lsmcu_pbl2_on == 0) && (PNEU_GetPressure(PNEU_RESERVOIR_CP) > PBL2_MIN_CP_PRESSURE_MILLIBARS)) {
 			// Send command on change.
 			LSSGKCU_Send(LSMCU_OUT_FPB_ON);
-			// Start CG and RE manometers.
-			MANO_SetTarget(&lsmcu_ctx.lsmcu_mano_cg, PBL2_ON_CG_PRESSURE_DECIBARS);
-			MANO_StartNeedle(&lsmcu_ctx.lsmcu_mano_cg);
-			MANO_SetTarget(&lsmcu_ctx.lsmcu_mano_re, PBL2_ON_CG_PRESSURE_DECIBARS);
-			MANO_StartNeedle(&lsmcu_ctx.lsmcu_mano_re);
-			// Update global context.
-			lsmcu_ctx.lsmcu_pbl2_on = 1;
+			// Update global context (CG and RE are charged by pneumatic model).
+			SIG_Write(&(lsmcu_ctx.lsmcu_pbl2_on), 1);
 		}
 		break;
 	case SW4_P3:
@@ -0,0 +1,253 @@
+/*
+ * pneu.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "pneu.h"
+
+#include "common.h"
+#include "mano.h"
+#include "sw3.h"
+#include "tim.h"
+
+/*** PNEU local macros ***/
+
+#define PNEU_PERIOD_MS						100		// Model integration period, all flows below are given per period.
+#define PNEU_CATCH_UP_MAX					10		// Maximum number of integration steps per call (model time is resynchronized beyond).
+// Main reservoir.
+#define PNEU_CP_RELIEF_MBAR					9500	// Safety valve opening pressure.
+#define PNEU_CP_COMPRESSOR_FLOW_MBAR		40		// Compressor output (0.4 bar/s).
+#define PNEU_CP_LEAK_FLOW_MBAR				1		// Leakage of the whole circuit.
+#define PNEU_CP_VOLUME_RATIO				4		// Main reservoir volume compared to the volumes it feeds.
+// Equalizing reservoir (FD).
+#define PNEU_RE_REGULATED_MBAR				3500	// Running pressure.
+#define PNEU_RE_FULL_SERVICE_MBAR			2000	// Lowest pressure reachable with FD (full service braking).
+#define PNEU_RE_FLOW_MBAR					30		// Apply and release rate of FD (0.3 bar/s).
+// Brake pipe.
+#define PNEU_CG_TIME_SHIFT					3		// Relay valve time constant (8 periods).
+#define PNEU_CG_URGENCY_TIME_SHIFT			1		// Venting time constant in urgency (2 periods).
+// Brake cylinders.
+#define PNEU_CF_MAX_MBAR					3800	// Full braking pressure.
+#define PNEU_CF_TRIPLE_VALVE_GAIN_PERCENT	250		// Cylinders pressure per brake pipe depression.
+#define PNEU_CF_FPB_FLOW_MBAR				50		// Apply and release rate of FPB (0.5 bar/s).
+#define PNEU_CF_TIME_SHIFT					2		// Cylinders filling time constant (4 periods).
+
+/*** PNEU local structures ***/
+
+typedef struct {
+	int pneu_pressure_mbar[PNEU_RESERVOIR_LAST];
+	MANO_Context* pneu_mano[PNEU_RESERVOIR_LAST]; // Manometer displaying each reservoir.
+	int pneu_re_setpoint_mbar; // Equalizing reservoir pressure requested by FD.
+	int pneu_fpb_command_mbar; // Cylinders pressure requested by FPB.
+	unsigned char pneu_pbl2_on_previous;
+	unsigned int pneu_model_time_ms; // Time of the last model integration.
+} PNEU_Context;
+
+/*** PNEU local global variables ***/
+
+static PNEU_Context pneu_ctx;
+
+/*** PNEU local functions ***/
+
+/* COMPUTE FIRST ORDER FLOW TOWARDS A SETPOINT.
+ * @param pressure_mbar:	Current pressure of the reservoir.
+ * @param setpoint_mbar:	Pressure to reach.
+ * @param time_shift:		Time constant expressed as a power of 2 of model periods.
+ * @return flow_mbar:		Pressure variation to apply during the current period.
+ */
+int PNEU_ComputeFlow(int pressure_mbar, int setpoint_mbar, unsigned char time_shift) {
+	int flow_mbar = (setpoint_mbar - pressure_mbar) / (1 << time_shift);
+	// Ensure setpoint is reached despite integer rounding.
+	if ((flow_mbar == 0) && (setpoint_mbar != pressure_mbar)) {
+		flow_mbar = (setpoint_mbar > pressure_mbar) ? 1 : (-1);
+	}
+	return flow_mbar;
+}
+
+/* FEED A RESERVOIR FROM THE MAIN RESERVOIR.
+ * @param reservoir:	Reservoir to update.
+ * @param flow_mbar:	Requested pressure variation.
+ * @return:				None.
+ */
+void PNEU_Feed(PNEU_Reservoir reservoir, int flow_mbar) {
+	int cp_mbar = pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP];
+	// A reservoir can not be filled above main reservoir pressure.
+	if (flow_mbar > 0) {
+		if ((pneu_ctx.pneu_pressure_mbar[reservoir] + flow_mbar) > cp_mbar) {
+			flow_mbar = cp_mbar - pneu_ctx.pneu_pressure_mbar[reservoir];
+		}
+		if (flow_mbar > 0) {
+			pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] -= (flow_mbar / PNEU_CP_VOLUME_RATIO);
+		}
+		else {
+			flow_mbar = 0;
+		}
+	}
+	pneu_ctx.pneu_pressure_mbar[reservoir] += flow_mbar;
+	if (pneu_ctx.pneu_pressure_mbar[reservoir] < 0) {
+		pneu_ctx.pneu_pressure_mbar[reservoir] = 0;
+	}
+}
+
+/* INTEGRATE PNEUMATIC MODEL OVER ONE PERIOD.
+ * @param:	None.
+ * @return:	None.
+ */
+void PNEU_ModelStep(void) {
+	int cf_command_mbar = 0;
+	int triple_valve_mbar = 0;
+	unsigned char cg_time_shift = PNEU_CG_TIME_SHIFT;
+	// Main reservoir.
+	if (lsmcu_ctx.lsmcu_compressor_on != 0) {
+		pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] += PNEU_CP_COMPRESSOR_FLOW_MBAR;
+	}
+	pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] -= PNEU_CP_LEAK_FLOW_MBAR;
+	if (pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] > PNEU_CP_RELIEF_MBAR) {
+		pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] = PNEU_CP_RELIEF_MBAR;
+	}
+	if (pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] < 0) {
+		pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CP] = 0;
+	}
+	// Equalizing reservoir setpoint.
+	if ((lsmcu_ctx.lsmcu_pbl2_on == 0) || (lsmcu_ctx.lsmcu_urgency != 0)) {
+		// Brake pipe vented.
+		pneu_ctx.pneu_re_setpoint_mbar = 0;
+		if (lsmcu_ctx.lsmcu_urgency != 0) {
+			cg_time_shift = PNEU_CG_URGENCY_TIME_SHIFT;
+		}
+	}
+	else {
+		if (pneu_ctx.pneu_pbl2_on_previous == 0) {
+			// Brake pipe charging when PBL2 is set to service.
+			pneu_ctx.pneu_re_setpoint_mbar = PNEU_RE_REGULATED_MBAR;
+		}
+		switch (lsmcu_ctx.lsmcu_fd_position) {
+		case SW3_BACK:
+			// Release.
+			pneu_ctx.pneu_re_setpoint_mbar += PNEU_RE_FLOW_MBAR;
+			if (pneu_ctx.pneu_re_setpoint_mbar > PNEU_RE_REGULATED_MBAR) {
+				pneu_ctx.pneu_re_setpoint_mbar = PNEU_RE_REGULATED_MBAR;
+			}
+			break;
+		case SW3_FRONT:
+			// Apply.
+			if (pneu_ctx.pneu_re_setpoint_mbar > PNEU_RE_FULL_SERVICE_MBAR) {
+				pneu_ctx.pneu_re_setpoint_mbar -= PNEU_RE_FLOW_MBAR;
+			}
+			break;
+		default:
+			// Lap position.
+			break;
+		}
+	}
+	pneu_ctx.pneu_pbl2_on_previous = lsmcu_ctx.lsmcu_pbl2_on;
+	// Equalizing reservoir and brake pipe (relay valve).
+	PNEU_Feed(PNEU_RESERVOIR_RE, PNEU_ComputeFlow(pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_RE], pneu_ctx.pneu_re_setpoint_mbar, 0));
+	PNEU_Feed(PNEU_RESERVOIR_CG, PNEU_ComputeFlow(pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CG], pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_RE], cg_time_shift));
+	// Independent brake (FPB).
+	if (lsmcu_ctx.lsmcu_pbl2_on != 0) {
+		switch (lsmcu_ctx.lsmcu_fpb_position) {
+		case SW3_BACK:
+			// Release.
+			pneu_ctx.pneu_fpb_command_mbar -= PNEU_CF_FPB_FLOW_MBAR;
+			if (pneu_ctx.pneu_fpb_command_mbar < 0) {
+				pneu_ctx.pneu_fpb_command_mbar = 0;
+			}
+			break;
+		case SW3_FRONT:
+			// Apply.
+			pneu_ctx.pneu_fpb_command_mbar += PNEU_CF_FPB_FLOW_MBAR;
+			if (pneu_ctx.pneu_fpb_command_mbar > PNEU_CF_MAX_MBAR) {
+				pneu_ctx.pneu_fpb_command_mbar = PNEU_CF_MAX_MBAR;
+			}
+			break;
+		default:
+			// Lap position.
+			break;
+		}
+	}
+	else {
+		pneu_ctx.pneu_fpb_command_mbar = 0;
+	}
+	// Automatic brake (triple valve driven by brake pipe depression).
+	triple_valve_mbar = ((PNEU_RE_REGULATED_MBAR - pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CG]) * PNEU_CF_TRIPLE_VALVE_GAIN_PERCENT) / 100;
+	if (triple_valve_mbar > PNEU_CF_MAX_MBAR) {
+		triple_valve_mbar = PNEU_CF_MAX_MBAR;
+	}
+	// Double check valve selects the highest command.
+	cf_command_mbar = (triple_valve_mbar > pneu_ctx.pneu_fpb_command_mbar) ? triple_valve_mbar : pneu_ctx.pneu_fpb_command_mbar;
+	if (cf_command_mbar < 0) {
+		cf_command_mbar = 0;
+	}
+	// Brake cylinders.
+	PNEU_Feed(PNEU_RESERVOIR_CF1, PNEU_ComputeFlow(pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CF1], cf_command_mbar, PNEU_CF_TIME_SHIFT));
+	PNEU_Feed(PNEU_RESERVOIR_CF2, PNEU_ComputeFlow(pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_CF2], cf_command_mbar, PNEU_CF_TIME_SHIFT));
+}
+
+/*** PNEU functions ***/
+
+/* INIT PNEUMATIC MODEL.
+ * @param:	None.
+ * @return:	None.
+ */
+void PNEU_Init(void) {
+	unsigned char idx = 0;
+	// Init context.
+	pneu_ctx.pneu_mano[PNEU_RESERVOIR_CP] = &(lsmcu_ctx.lsmcu_mano_cp);
+	pneu_ctx.pneu_mano[PNEU_RESERVOIR_RE] = &(lsmcu_ctx.lsmcu_mano_re);
+	pneu_ctx.pneu_mano[PNEU_RESERVOIR_CG] = &(lsmcu_ctx.lsmcu_mano_cg);
+	pneu_ctx.pneu_mano[PNEU_RESERVOIR_CF1] = &(lsmcu_ctx.lsmcu_mano_cf1);
+	pneu_ctx.pneu_mano[PNEU_RESERVOIR_CF2] = &(lsmcu_ctx.lsmcu_mano_cf2);
+	// Start from the pressures displayed by the needles (restored from backup SRAM by MANO_Init).
+	for (idx=0 ; idx<PNEU_RESERVOIR_LAST ; idx++) {
+		pneu_ctx.pneu_pressure_mbar[idx] = (int) MANO_GetPressureMillibars(pneu_ctx.pneu_mano[idx]);
+	}
+	pneu_ctx.pneu_re_setpoint_mbar = pneu_ctx.pneu_pressure_mbar[PNEU_RESERVOIR_RE];
+	pneu_ctx.pneu_fpb_command_mbar = 0;
+	pneu_ctx.pneu_pbl2_on_previous = 0;
+	pneu_ctx.pneu_model_time_ms = TIM2_GetMs();
+	// Init global context.
+	lsmcu_ctx.lsmcu_fd_position = SW3_NEUTRAL;
+	lsmcu_ctx.lsmcu_fpb_position = SW3_NEUTRAL;
+}
+
+/* GET CURRENT PRESSURE OF A RESERVOIR.
+ * @param reservoir:			Reservoir to read.
+ * @return pressure_millibars:	Pressure computed by the model in millibars.
+ */
+unsigned int PNEU_GetPressure(PNEU_Reservoir reservoir) {
+	unsigned int pressure_millibars = 0;
+	if (reservoir < PNEU_RESERVOIR_LAST) {
+		pressure_millibars = (unsigned int) pneu_ctx.pneu_pressure_mbar[reservoir];
+	}
+	return pressure_millibars;
+}
+
+/* MAIN TASK OF PNEUMATIC MODEL.
+ * @param:	None.
+ * @return:	None.
+ */
+void PNEU_Task(void) {
+	unsigned char idx = 0;
+	unsigned char iteration_count = 0;
+	unsigned int now_ms = TIM2_GetMs();
+	// Catch up missed periods.
+	while (((int) (now_ms - pneu_ctx.pneu_model_time_ms)) >= PNEU_PERIOD_MS) {
+		PNEU_ModelStep();
+		pneu_ctx.pneu_model_time_ms += PNEU_PERIOD_MS;
+		iteration_count++;
+		// Resynchronize model time if main loop was blocked too long.
+		if (iteration_count >= PNEU_CATCH_UP_MAX) {
+			pneu_ctx.pneu_model_time_ms = now_ms;
+			break;
+		}
+	}
+	// Publish pressures to manometers.
+	if (iteration_count != 0) {
+		for (idx=0 ; idx<PNEU_RESERVOIR_LAST ; idx++) {
+			MANO_SetTargetMillibars(pneu_ctx.pneu_mano[idx], pneu_ctx.pneu_pressure_mbar[idx]);
+		}
+	}
+}
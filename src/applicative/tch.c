@@ -9,46 +9,92 @@
 
 #include "common.h"
 #include "mapping.h"
+#include "pwrm.h"
+#include "tcm.h"
 #include "tim.h"
 
 /*** TCH local macros ***/
 
 // Speed under which the Tachro is off (not accurate enough).
 #define TCH_SPEED_MIN_KMH	5
+// Step delay in s is given by TCH_STEP_DELAY_NUMERATOR / (speed_centikmh + TCH_STEP_DELAY_OFFSET_CENTIKMH) (calibrated on the Tachro).
+#define TCH_STEP_DELAY_NUMERATOR		187309300
+#define TCH_STEP_DELAY_OFFSET_CENTIKMH	96
+// Maximum needle acceleration keeping the synchronous motor locked.
+#define TCH_ACCELERATION_KMH_PER_S		40
+// Commutation sequence.
+#define TCH_STEPS_NUMBER	6
+#define TCH_OUTPUTS_NUMBER	6
+#define TCH_INH_A			(0b1 << 0)
+#define TCH_INH_B			(0b1 << 1)
+#define TCH_INH_C			(0b1 << 2)
+#define TCH_PWM_A			(0b1 << 3)
+#define TCH_PWM_B			(0b1 << 4)
+#define TCH_PWM_C			(0b1 << 5)
 
 /*** TCH local structures ***/
 
 // Internal state machine.
 typedef enum {
 	TCH_STATE_OFF,
-	TCH_STATE_STEP1,
-	TCH_STATE_STEP2,
-	TCH_STATE_STEP3,
-	TCH_STATE_STEP4,
-	TCH_STATE_STEP5,
-	TCH_STATE_STEP6,
+	TCH_STATE_RUNNING
 } TCH_State;
 
+typedef struct {
+	TCH_State tch_state;
+	unsigned int tch_step_bsrr[TCH_STEPS_NUMBER]; // BSRR word of each step (all outputs are on the same port).
+	unsigned int tch_off_bsrr; // BSRR word switching all outputs off.
+	volatile unsigned char tch_step_idx; // Next step to apply.
+	unsigned int tch_speed_centikmh; // Speed currently displayed, slewed towards host speed.
+	unsigned int tch_slew_time_ms; // Time of the last displayed speed update.
+} TCH_Context;
+
 /*** TCH local global variables ***/
 
-// step_delay_us[v] = delay between each step in s required to display v km/h.
-static const unsigned int tch_step_delay_us[TCH_SPEED_MAX_KMH+1] = {0, 0, 0, 0, 0, 314278, 269123, 235314, 209051, 188062, 170904,
-														     	 	156614, 144530, 134177, 125208, 117363, 110443, 104293, 98793, 93843, 89366,
-																	85296, 81581, 78177, 75044, 72154, 69477, 66993, 64679, 62520, 60501,
-																	58608, 56830, 55156, 53579, 52089, 50679, 49344, 48078, 46875, 45730,
-																	44640, 43601, 42609, 41662, 40755, 39887, 39056, 38258, 37492, 36757,
-																	36049, 35368, 34713, 34081, 33472, 32885, 32317, 31769, 31239, 30727,
-																	30231, 29751, 29286, 28835, 28398, 27974, 27562, 27162, 26774, 26397,
-																	26030, 25673, 25326, 24988, 24659, 24339, 24027, 23722, 23426, 23136,
-																	22854, 22579, 22310, 22047, 21791, 21540, 21295, 21056, 20822, 20593,
-																	20369, 20150, 19935, 19725, 19520, 19318, 19121, 18928, 18739, 18553,
-																	18371, 18193, 18018, 17846, 17678, 17512, 17350, 17191, 17035, 16881,
-																	16730, 16582, 16437, 16294, 16153, 16015, 15879, 15746, 15614, 15485,
-																	15358, 15234, 15111, 14990, 14871, 14754, 14638, 14525, 14413, 14303,
-																	14195, 14088, 13983, 13879, 13777, 13676, 13577, 13480, 13383, 13288,
-																	13195, 13102, 13011, 12922, 12833, 12746, 12660, 12575, 12491, 12408,
-																	12326, 12246, 12166, 12088, 12010, 11934, 11858, 11784, 11710, 11637};
-static TCH_State tch_state;
+// Outputs order used in steps table.
+static const GPIO* const tch_outputs[TCH_OUTPUTS_NUMBER] = {&GPIO_TCH_INH_A, &GPIO_TCH_INH_B, &GPIO_TCH_INH_C, &GPIO_TCH_PWM_A, &GPIO_TCH_PWM_B, &GPIO_TCH_PWM_C};
+// Active outputs of each step.
+static const unsigned char tch_step_outputs[TCH_STEPS_NUMBER] = {
+	(TCH_INH_A | TCH_INH_B | TCH_PWM_A),
+	(TCH_INH_A | TCH_INH_C | TCH_PWM_A),
+	(TCH_INH_B | TCH_INH_C | TCH_PWM_B),
+	(TCH_INH_A | TCH_INH_B | TCH_PWM_B),
+	(TCH_INH_A | TCH_INH_C | TCH_PWM_C),
+	(TCH_INH_B | TCH_INH_C | TCH_PWM_C)
+};
+static TCH_Context tch_ctx TCM_DTCM_DATA;
+
+/*** TCH local functions ***/
+
+/* COMPUTE STEP DELAY REQUIRED TO DISPLAY A GIVEN SPEED.
+ * @param speed_centikmh:	Speed to display in 0.01 km/h.
+ * @return step_delay_us:	Delay between two steps in s.
+ */
+unsigned int TCH_ComputeStepDelayUs(unsigned int speed_centikmh) {
+	unsigned int step_delay_us = TCH_STEP_DELAY_NUMERATOR / (speed_centikmh + TCH_STEP_DELAY_OFFSET_CENTIKMH);
+	return step_delay_us;
+}
+
+/* SLEW DISPLAYED SPEED TOWARDS HOST SPEED.
+ * @param:	None.
+ * @return:	None.
+ */
+void TCH_SlewSpeed(void) {
+	unsigned int target_centikmh = (lsmcu_ctx.lsmcu_speed_kmh * 100);
+	unsigned int now_ms = TIM2_GetMs();
+	// Maximum speed variation since last update (acceleration in km/h/s is also the variation in 0.01 km/h per 10 ms).
+	unsigned int delta_centikmh = ((now_ms - tch_ctx.tch_slew_time_ms) * TCH_ACCELERATION_KMH_PER_S) / 10;
+	// Wait until the allowed variation is at least 0.01 km/h.
+	if (delta_centikmh != 0) {
+		tch_ctx.tch_slew_time_ms = now_ms;
+		if (tch_ctx.tch_speed_centikmh < target_centikmh) {
+			tch_ctx.tch_speed_centikmh = ((target_centikmh - tch_ctx.tch_speed_centikmh) > delta_centikmh) ? (tch_ctx.tch_speed_centikmh + delta_centikmh) : target_centikmh;
+		}
+		else {
+			tch_ctx.tch_speed_centikmh = ((tch_ctx.tch_speed_centikmh - target_centikmh) > delta_centikmh) ? (tch_ctx.tch_speed_centikmh - delta_centikmh) : target_centikmh;
+		}
+	}
+}
 
 /*** TCH functions ***/
 
@@ -57,173 +103,86 @@ static TCH_State tch_state;
  * @return:	None.
  */
 void TCH_Init(void) {
-	// Init INH outputs.
-	GPIO_Configure(&GPIO_TCH_INH_A, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_TCH_INH_B, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_TCH_INH_C, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	// Init PWM outputs
-	GPIO_Configure(&GPIO_TCH_PWM_A, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_TCH_PWM_B, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
-	GPIO_Configure(&GPIO_TCH_PWM_C, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	unsigned char step_idx = 0;
+	unsigned char output_idx = 0;
+	// Init outputs.
+	for (output_idx=0 ; output_idx<TCH_OUTPUTS_NUMBER ; output_idx++) {
+		GPIO_Configure(tch_outputs[output_idx], GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
+	}
+	// Precompute BSRR words (upper half resets outputs, lower half sets outputs).
+	tch_ctx.tch_off_bsrr = 0;
+	for (output_idx=0 ; output_idx<TCH_OUTPUTS_NUMBER ; output_idx++) {
+		tch_ctx.tch_off_bsrr |= (0b1 << ((tch_outputs[output_idx] -> gpio_num) + 16));
+	}
+	for (step_idx=0 ; step_idx<TCH_STEPS_NUMBER ; step_idx++) {
+		tch_ctx.tch_step_bsrr[step_idx] = 0;
+		for (output_idx=0 ; output_idx<TCH_OUTPUTS_NUMBER ; output_idx++) {
+			if ((tch_step_outputs[step_idx] & (0b1 << output_idx)) != 0) {
+				tch_ctx.tch_step_bsrr[step_idx] |= (0b1 << (tch_outputs[output_idx] -> gpio_num));
+			}
+			else {
+				tch_ctx.tch_step_bsrr[step_idx] |= (0b1 << ((tch_outputs[output_idx] -> gpio_num) + 16));
+			}
+		}
+	}
 	// Init context.
-	tch_state = TCH_STATE_OFF;
+	tch_ctx.tch_state = TCH_STATE_OFF;
+	tch_ctx.tch_step_idx = 0;
+	tch_ctx.tch_speed_centikmh = 0;
+	tch_ctx.tch_slew_time_ms = TIM2_GetMs();
+	(GPIO_TCH_INH_A.gpio_port_address) -> BSRR = tch_ctx.tch_off_bsrr;
 	// Init global context.
 	lsmcu_ctx.lsmcu_speed_kmh = 0;
 }
 
+/* APPLY NEXT TACHRO STEP (CALLED BY TIM5 INTERRUPT HANDLER).
+ * @param:	None.
+ * @return:	None.
+ */
+void TCM_ITCM_FUNCTION TCH_Commutate(void) {
+	// All outputs are updated in a single store.
+	(GPIO_TCH_INH_A.gpio_port_address) -> BSRR = tch_ctx.tch_step_bsrr[tch_ctx.tch_step_idx];
+	tch_ctx.tch_step_idx++;
+	if (tch_ctx.tch_step_idx >= TCH_STEPS_NUMBER) {
+		tch_ctx.tch_step_idx = 0;
+	}
+}
+
 /* MAIN ROUTINE OF TCH CONTROL INTERFACE.
  * @param:	None.
  * @return:	None.
  */
 void TCH_Task(void) {
+	// Update displayed speed.
+	TCH_SlewSpeed();
 	// Perform state machine.
-	switch (tch_state) {
+	switch (tch_ctx.tch_state) {
 	case TCH_STATE_OFF:
-		// All outputs off.
-		GPIO_Write(&GPIO_TCH_INH_A, 0);
-		GPIO_Write(&GPIO_TCH_INH_B, 0);
-		GPIO_Write(&GPIO_TCH_INH_C, 0);
-		GPIO_Write(&GPIO_TCH_PWM_A, 0);
-		GPIO_Write(&GPIO_TCH_PWM_B, 0);
-		GPIO_Write(&GPIO_TCH_PWM_C, 0);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh >= TCH_SPEED_MIN_KMH) {
-			// Start timer and go to first step.
+		if (tch_ctx.tch_speed_centikmh >= (TCH_SPEED_MIN_KMH * 100)) {
+			// Apply first step and start timer (next steps are performed under interrupt).
+			PWRM_Wake(); // TIM5 is gated in standby.
+			tch_ctx.tch_step_idx = 0;
+			TCH_Commutate();
+			TIM5_SetDelayUs(TCH_ComputeStepDelayUs(tch_ctx.tch_speed_centikmh));
 			TIM5_Start();
-			TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-			TIM5_ClearUifFlag();
-			tch_state = TCH_STATE_STEP1;
+			tch_ctx.tch_state = TCH_STATE_RUNNING;
 		}
 		break;
-	case TCH_STATE_STEP1:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_A, 1);
-		GPIO_Write(&GPIO_TCH_INH_B, 1);
-		GPIO_Write(&GPIO_TCH_INH_C, 0);
-		GPIO_Write(&GPIO_TCH_PWM_A, 1);
-		GPIO_Write(&GPIO_TCH_PWM_C, 0);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
+	case TCH_STATE_RUNNING:
+		if (tch_ctx.tch_speed_centikmh < (TCH_SPEED_MIN_KMH * 100)) {
+			// Stop timer and switch all outputs off.
 			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
+			(GPIO_TCH_INH_A.gpio_port_address) -> BSRR = tch_ctx.tch_off_bsrr;
+			tch_ctx.tch_state = TCH_STATE_OFF;
 		}
 		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP2;
-			}
-		}
-		break;
-	case TCH_STATE_STEP2:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_B, 0);
-		GPIO_Write(&GPIO_TCH_INH_C, 1);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
-			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
-		}
-		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP3;
-			}
-		}
-		break;
-	case TCH_STATE_STEP3:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_A, 0);
-		GPIO_Write(&GPIO_TCH_INH_B, 1);
-		GPIO_Write(&GPIO_TCH_PWM_A, 0);
-		GPIO_Write(&GPIO_TCH_PWM_B, 1);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
-			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
-		}
-		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP4;
-			}
-		}
-		break;
-	case TCH_STATE_STEP4:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_A, 1);
-		GPIO_Write(&GPIO_TCH_INH_C, 0);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
-			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
-		}
-		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP5;
-			}
-		}
-		break;
-	case TCH_STATE_STEP5:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_B, 0);
-		GPIO_Write(&GPIO_TCH_INH_C, 1);
-		GPIO_Write(&GPIO_TCH_PWM_B, 0);
-		GPIO_Write(&GPIO_TCH_PWM_C, 1);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
-			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
-		}
-		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP6;
-			}
-		}
-		break;
-	case TCH_STATE_STEP6:
-		// Toggle required outputs.
-		GPIO_Write(&GPIO_TCH_INH_A, 0);
-		GPIO_Write(&GPIO_TCH_INH_B, 1);
-		// State evolution.
-		if (lsmcu_ctx.lsmcu_speed_kmh < TCH_SPEED_MIN_KMH) {
-			// Stop timer and switch Tachro off.
-			TIM5_Stop();
-			tch_state = TCH_STATE_OFF;
-		}
-		else {
-			// Check delay.
-			if (TIM5_GetUifFlag() != 0) {
-				// Clear flag, update delay and go to next step.
-				TIM5_SetDelayUs(tch_step_delay_us[lsmcu_ctx.lsmcu_speed_kmh]);
-				TIM5_ClearUifFlag();
-				tch_state = TCH_STATE_STEP1;
-			}
+			// Update period (taken into account on next step).
+			TIM5_SetDelayUs(TCH_ComputeStepDelayUs(tch_ctx.tch_speed_centikmh));
 		}
 		break;
 	default:
 		// Unknown state.
+		tch_ctx.tch_state = TCH_STATE_OFF;
 		break;
 	}
 }
@@ -10,8 +10,9 @@
 #include "common.h"
 #include "gpio.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw2.h"
-#include "tim.h"
+#include "timer.h"
 
 /*** VACMA local macros ***/
 
@@ -36,13 +37,47 @@ typedef struct {
 	SW2_Context vacma_mp_va;
 	// State machine.
 	VACMA_State vacma_state;
-	unsigned int vacma_switch_state_time; // In ms.
+	TIMER_Context vacma_timer; // Alarm and urgency deadlines.
 } VACMA_Context;
 
 /*** VACMA local global variables ***/
 
 static VACMA_Context vacma_ctx;
 
+/*** VACMA local functions ***/
+
+/* PERFORM TIMED TRANSITIONS OF VACMA STATE MACHINE (CALLED BY TIMER_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void VACMA_TimerCallback(void) {
+	switch (vacma_ctx.vacma_state) {
+	case VACMA_STATE_HOLD:
+		// Trigger hold alarm.
+		GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 1);
+		TIMER_Start(&vacma_ctx.vacma_timer, VACMA_ALARM_DURATION_MS);
+		vacma_ctx.vacma_state = VACMA_STATE_HOLD_ALARM;
+		break;
+	case VACMA_STATE_RELEASED:
+		// Trigger released alarm.
+		GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 1);
+		TIMER_Start(&vacma_ctx.vacma_timer, VACMA_ALARM_DURATION_MS);
+		vacma_ctx.vacma_state = VACMA_STATE_RELEASED_ALARM;
+		break;
+	case VACMA_STATE_HOLD_ALARM:
+	case VACMA_STATE_RELEASED_ALARM:
+		// Trigger urgency brake.
+		GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
+		GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
+		SIG_Write(&(lsmcu_ctx.lsmcu_urgency), 1);
+		vacma_ctx.vacma_state = VACMA_STATE_URGENCY;
+		break;
+	default:
+		// No deadline in other states.
+		break;
+	}
+}
+
 /*** VACMA functions ***/
 
 /* INIT VACMA MODULE.
@@ -59,7 +94,7 @@ void VACMA_Init(void) {
 	GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
 	// Init context.
 	vacma_ctx.vacma_state = VACMA_STATE_OFF;
-	vacma_ctx.vacma_switch_state_time = 0;
+	TIMER_Register(&vacma_ctx.vacma_timer, &VACMA_TimerCallback);
 }
 
 /* MAIN ROUTINE OF VACMA MODULE.
@@ -77,105 +112,76 @@ void VACMA_Task(void) {
 		if ((lsmcu_ctx.lsmcu_speed_kmh > 0) || (vacma_ctx.vacma_bl_zva.sw2_state == SW2_ON)) {
 			// Enable VACMA.
 			if (vacma_ctx.vacma_mp_va.sw2_state == SW2_ON) {
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_HOLD_ALARM_START_MS);
 				vacma_ctx.vacma_state = VACMA_STATE_HOLD;
 			}
 			else {
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_RELEASED_ALARM_START_MS);
 				vacma_ctx.vacma_state = VACMA_STATE_RELEASED;
 			}
-			vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
 		}
 		break;
 	case VACMA_STATE_HOLD:
 		if ((lsmcu_ctx.lsmcu_speed_kmh == 0) && (vacma_ctx.vacma_bl_zva.sw2_state == SW2_OFF)) {
 			// Disable VACMA.
+			TIMER_Stop(&vacma_ctx.vacma_timer);
 			GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 			GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
 			vacma_ctx.vacma_state = VACMA_STATE_OFF;
 		}
 		else {
-			if (TIM2_GetMs() > (vacma_ctx.vacma_switch_state_time + VACMA_HOLD_ALARM_START_MS)) {
-				// Trigger hold alarm.
-				GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 1);
-				vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-				vacma_ctx.vacma_state = VACMA_STATE_HOLD_ALARM;
-			}
-			else {
-				if (vacma_ctx.vacma_mp_va.sw2_state == SW2_OFF) {
-					vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-					vacma_ctx.vacma_state = VACMA_STATE_RELEASED;
-				}
+			if (vacma_ctx.vacma_mp_va.sw2_state == SW2_OFF) {
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_RELEASED_ALARM_START_MS);
+				vacma_ctx.vacma_state = VACMA_STATE_RELEASED;
 			}
 		}
 		break;
 	case VACMA_STATE_HOLD_ALARM:
 		if ((lsmcu_ctx.lsmcu_speed_kmh == 0) && (vacma_ctx.vacma_bl_zva.sw2_state == SW2_OFF)) {
 			// Disable VACMA.
+			TIMER_Stop(&vacma_ctx.vacma_timer);
 			GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 			GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
 			vacma_ctx.vacma_state = VACMA_STATE_OFF;
 		}
 		else {
-			if (TIM2_GetMs() > (vacma_ctx.vacma_switch_state_time + VACMA_ALARM_DURATION_MS)) {
-				// Trigger urgency brake.
+			if (vacma_ctx.vacma_mp_va.sw2_state == SW2_OFF) {
 				GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 				GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
-				lsmcu_ctx.lsmcu_urgency = 1;
-				vacma_ctx.vacma_state = VACMA_STATE_URGENCY;
-			}
-			else {
-				if (vacma_ctx.vacma_mp_va.sw2_state == SW2_OFF) {
-					GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
-					GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
-					vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-					vacma_ctx.vacma_state = VACMA_STATE_RELEASED;
-				}
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_RELEASED_ALARM_START_MS);
+				vacma_ctx.vacma_state = VACMA_STATE_RELEASED;
 			}
 		}
 		break;
 	case VACMA_STATE_RELEASED:
 		if ((lsmcu_ctx.lsmcu_speed_kmh == 0) && (vacma_ctx.vacma_bl_zva.sw2_state == SW2_OFF)) {
 			// Disable VACMA.
+			TIMER_Stop(&vacma_ctx.vacma_timer);
 			GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 			GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
 			vacma_ctx.vacma_state = VACMA_STATE_OFF;
 		}
 		else {
-			if (TIM2_GetMs() > (vacma_ctx.vacma_switch_state_time + VACMA_RELEASED_ALARM_START_MS)) {
-				// Trigger released alarm.
-				GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 1);
-				vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-				vacma_ctx.vacma_state = VACMA_STATE_RELEASED_ALARM;
-			}
-			else {
-				if (vacma_ctx.vacma_mp_va.sw2_state == SW2_ON) {
-					vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-					vacma_ctx.vacma_state = VACMA_STATE_HOLD;
-				}
+			if (vacma_ctx.vacma_mp_va.sw2_state == SW2_ON) {
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_HOLD_ALARM_START_MS);
+				vacma_ctx.vacma_state = VACMA_STATE_HOLD;
 			}
 		}
 		break;
 	case VACMA_STATE_RELEASED_ALARM:
 		if ((lsmcu_ctx.lsmcu_speed_kmh == 0) && (vacma_ctx.vacma_bl_zva.sw2_state == SW2_OFF)) {
 			// Disable VACMA.
+			TIMER_Stop(&vacma_ctx.vacma_timer);
 			GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 			GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
 			vacma_ctx.vacma_state = VACMA_STATE_OFF;
 		}
 		else {
-			if (TIM2_GetMs() > (vacma_ctx.vacma_switch_state_time + VACMA_ALARM_DURATION_MS)) {
-				// Trigger urgency brake.
+			if (vacma_ctx.vacma_mp_va.sw2_state == SW2_ON) {
 				GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
 				GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
-				lsmcu_ctx.lsmcu_urgency = 1;
-				vacma_ctx.vacma_state = VACMA_STATE_URGENCY;
-			}
-			else {
-				if (vacma_ctx.vacma_mp_va.sw2_state == SW2_ON) {
-					GPIO_Write(&GPIO_VACMA_HOLD_ALARM, 0);
-					GPIO_Write(&GPIO_VACMA_RELEASED_ALARM, 0);
-					vacma_ctx.vacma_switch_state_time = TIM2_GetMs();
-					vacma_ctx.vacma_state = VACMA_STATE_HOLD;
-				}
+				TIMER_Start(&vacma_ctx.vacma_timer, VACMA_HOLD_ALARM_START_MS);
+				vacma_ctx.vacma_state = VACMA_STATE_HOLD;
 			}
 		}
 		break;
@@ -10,6 +10,8 @@
 #include "common.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "pwrm.h"
+#include "sig.h"
 #include "sw2.h"
 
 /*** ZBA local global variables ***/
@@ -39,15 +41,17 @@ void ZBA_Task(void) {
 	if (zba.sw2_state == SW2_ON) {
 		// Send command on change.
 		if (lsmcu_ctx.lsmcu_zba_closed == 0) {
+			// Restore full speed before modules see the cab powered.
+			PWRM_Wake();
 			LSSGKCU_Send(LSMCU_OUT_ZBA_ON);
 		}
-		lsmcu_ctx.lsmcu_zba_closed = 1;
+		SIG_Write(&(lsmcu_ctx.lsmcu_zba_closed), 1);
 	}
 	else {
 		// Send command on change.
 		if (lsmcu_ctx.lsmcu_zba_closed != 0) {
 			LSSGKCU_Send(LSMCU_OUT_ZBA_OFF);
 		}
-		lsmcu_ctx.lsmcu_zba_closed = 0;
+		SIG_Write(&(lsmcu_ctx.lsmcu_zba_closed), 0);
 	}
 }
@@ -11,6 +11,7 @@
 #include "gpio.h"
 #include "lssgkcu.h"
 #include "mapping.h"
+#include "sig.h"
 #include "sw4.h"
 
 /*** ZPT local structures ***/
@@ -74,7 +75,7 @@ void ZPT_Task(void) {
 				// Rise back pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_AR;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P2:
@@ -82,14 +83,14 @@ void ZPT_Task(void) {
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_UP);
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_ARAV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P3:
 				// Rise front pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_AV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			default:
@@ -104,7 +105,7 @@ void ZPT_Task(void) {
 				// Lower back pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_0;
-				lsmcu_ctx.lsmcu_zpt_raised = 0;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 				GPIO_Write(&GPIO_VLG, 1);
 				break;
 			case SW4_P1:
@@ -114,7 +115,7 @@ void ZPT_Task(void) {
 				// Rise front pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_ARAV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P3:
@@ -122,7 +123,7 @@ void ZPT_Task(void) {
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_AV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			}
@@ -131,7 +132,7 @@ void ZPT_Task(void) {
 			// Disable ZPT.
 			LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 			zpt_ctx.zpt_state = ZPT_STATE_0;
-			lsmcu_ctx.lsmcu_zpt_raised = 0;
+			SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 			GPIO_Write(&GPIO_VLG, 1);
 		}
 		break;
@@ -143,14 +144,14 @@ void ZPT_Task(void) {
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_0;
-				lsmcu_ctx.lsmcu_zpt_raised = 0;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P1:
 				// Lower back and raise front pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_AR;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P2:
@@ -160,7 +161,7 @@ void ZPT_Task(void) {
 				// Lower back pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_AV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			}
@@ -170,7 +171,7 @@ void ZPT_Task(void) {
 			LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_DOWN);
 			LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 			zpt_ctx.zpt_state = ZPT_STATE_0;
-			lsmcu_ctx.lsmcu_zpt_raised = 0;
+			SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 			GPIO_Write(&GPIO_VLG, 1);
 		}
 		break;
@@ -181,7 +182,7 @@ void ZPT_Task(void) {
 				// Lower front pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_0;
-				lsmcu_ctx.lsmcu_zpt_raised = 0;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 				GPIO_Write(&GPIO_VLG, 1);
 				break;
 			case SW4_P1:
@@ -189,14 +190,14 @@ void ZPT_Task(void) {
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_UP);
 				LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 				zpt_ctx.zpt_state = ZPT_STATE_AR;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P2:
 				// Rise back pantograph.
 				LSSGKCU_Send(LSMCU_OUT_ZPT_BACK_UP);
 				zpt_ctx.zpt_state = ZPT_STATE_ARAV;
-				lsmcu_ctx.lsmcu_zpt_raised = 1;
+				SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 1);
 				GPIO_Write(&GPIO_VLG, 0);
 				break;
 			case SW4_P3:
@@ -208,7 +209,7 @@ void ZPT_Task(void) {
 			// Disable ZPT.
 			LSSGKCU_Send(LSMCU_OUT_ZPT_FRONT_DOWN);
 			zpt_ctx.zpt_state = ZPT_STATE_0;
-			lsmcu_ctx.lsmcu_zpt_raised = 0;
+			SIG_Write(&(lsmcu_ctx.lsmcu_zpt_raised), 0);
 			GPIO_Write(&GPIO_VLG, 1);
 		}
 		break;
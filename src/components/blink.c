@@ -0,0 +1,173 @@
+/*
+ * blink.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "blink.h"
+
+#include "gpio.h"
+#include "nvic.h"
+#include "tim.h"
+
+/*** BLINK local structures ***/
+
+typedef struct {
+	BLINK_Context* blink_list; // Registered blinking outputs.
+} BLINK_EngineContext;
+
+/*** BLINK local global variables ***/
+
+static BLINK_EngineContext blink_engine_ctx;
+
+/*** BLINK local functions ***/
+
+/* PROGRAM TIM2 COMPARE CHANNEL ON THE NEAREST EDGE OF ALL ACTIVE BLINKING OUTPUTS.
+ * @param:	None.
+ * @return:	None.
+ */
+void BLINK_Schedule(void) {
+	BLINK_Context* blink = blink_engine_ctx.blink_list;
+	unsigned int now_ms = TIM2_GetMs();
+	unsigned int next_edge_time_ms = 0;
+	unsigned char edge_found = 0;
+	// Search nearest edge (differences are computed on signed values to handle timer wrap).
+	while (blink != 0) {
+		if ((blink -> blink_active) != 0) {
+			if ((edge_found == 0) || (((int) ((blink -> blink_next_edge_time_ms) - next_edge_time_ms)) < 0)) {
+				next_edge_time_ms = (blink -> blink_next_edge_time_ms);
+				edge_found = 1;
+			}
+		}
+		blink = (blink -> blink_next);
+	}
+	if (edge_found == 0) {
+		// Nothing to do.
+		TIM2_EnableCompareInterrupt(0);
+	}
+	else {
+		TIM2_SetCompareMs(next_edge_time_ms);
+		TIM2_EnableCompareInterrupt(1);
+		// Counter may have reached or passed the edge before compare register was written.
+		now_ms = TIM2_GetMs();
+		if (((int) (now_ms - next_edge_time_ms)) >= 0) {
+			TIM2_ForceCompareEvent();
+		}
+	}
+}
+
+/*** BLINK functions ***/
+
+/* INIT BLINK ENGINE.
+ * @param:	None.
+ * @return:	None.
+ */
+void BLINK_Init(void) {
+	// Init context.
+	blink_engine_ctx.blink_list = 0;
+	// Compare interrupt is enabled only when an output is blinking.
+	TIM2_EnableCompareInterrupt(0);
+	NVIC_EnableInterrupt(IT_TIM2);
+}
+
+/* ATTACH A BLINKING OUTPUT TO THE ENGINE.
+ * @param blink:			Blinking context.
+ * @param blink_gpio:		GPIO to control.
+ * @param off_duration_ms:	Duration of the off phase of each cycle (in ms).
+ * @param on_duration_ms:	Duration of the on phase of each cycle (in ms).
+ * @return:					None.
+ */
+void BLINK_Register(BLINK_Context* blink, const GPIO* blink_gpio, unsigned int off_duration_ms, unsigned int on_duration_ms) {
+	BLINK_Context* registered_blink = blink_engine_ctx.blink_list;
+	// Init context.
+	NVIC_DisableInterrupt(IT_TIM2);
+	(blink -> blink_gpio) = blink_gpio;
+	(blink -> blink_off_duration_ms) = off_duration_ms;
+	(blink -> blink_on_duration_ms) = on_duration_ms;
+	(blink -> blink_remaining_cycles) = 0;
+	(blink -> blink_active) = 0;
+	(blink -> blink_output_state) = 0;
+	(blink -> blink_next_edge_time_ms) = 0;
+	// Add context to list if not already registered.
+	while (registered_blink != 0) {
+		if (registered_blink == blink) break;
+		registered_blink = (registered_blink -> blink_next);
+	}
+	if (registered_blink == 0) {
+		(blink -> blink_next) = blink_engine_ctx.blink_list;
+		blink_engine_ctx.blink_list = blink;
+	}
+	NVIC_EnableInterrupt(IT_TIM2);
+}
+
+/* START BLINKING (EACH CYCLE IS AN OFF PHASE FOLLOWED BY AN ON PHASE).
+ * @param blink:			Blinking context.
+ * @param number_of_cycles:	Number of cycles to perform, output remains on at the end. 0 means infinite blinking.
+ * @return:					None.
+ */
+void BLINK_Start(BLINK_Context* blink, unsigned int number_of_cycles) {
+	NVIC_DisableInterrupt(IT_TIM2);
+	// Start off phase.
+	GPIO_Write((blink -> blink_gpio), 0);
+	(blink -> blink_output_state) = 0;
+	(blink -> blink_remaining_cycles) = number_of_cycles;
+	(blink -> blink_next_edge_time_ms) = TIM2_GetMs() + (blink -> blink_off_duration_ms);
+	(blink -> blink_active) = 1;
+	BLINK_Schedule();
+	NVIC_EnableInterrupt(IT_TIM2);
+}
+
+/* STOP BLINKING (OUTPUT IS LEFT IN ITS CURRENT STATE).
+ * @param blink:	Blinking context.
+ * @return:			None.
+ */
+void BLINK_Stop(BLINK_Context* blink) {
+	NVIC_DisableInterrupt(IT_TIM2);
+	(blink -> blink_active) = 0;
+	BLINK_Schedule();
+	NVIC_EnableInterrupt(IT_TIM2);
+}
+
+/* GET BLINKING STATUS.
+ * @param blink:	Blinking context.
+ * @return:			'1' if output is currently blinking, '0' otherwise.
+ */
+unsigned char BLINK_IsActive(BLINK_Context* blink) {
+	return (blink -> blink_active);
+}
+
+/* UPDATE OUTPUTS WHOSE EDGE IS REACHED (CALLED BY TIM2 COMPARE INTERRUPT).
+ * @param:	None.
+ * @return:	None.
+ */
+void BLINK_Process(void) {
+	BLINK_Context* blink = blink_engine_ctx.blink_list;
+	unsigned int now_ms = TIM2_GetMs();
+	while (blink != 0) {
+		if (((blink -> blink_active) != 0) && (((int) (now_ms - (blink -> blink_next_edge_time_ms))) >= 0)) {
+			if ((blink -> blink_output_state) == 0) {
+				// End of off phase.
+				GPIO_Write((blink -> blink_gpio), 1);
+				(blink -> blink_output_state) = 1;
+				// Next edge is computed from theoretical edge time to avoid drift.
+				(blink -> blink_next_edge_time_ms) += (blink -> blink_on_duration_ms);
+				// Manage number of cycles.
+				if ((blink -> blink_remaining_cycles) != 0) {
+					(blink -> blink_remaining_cycles)--;
+					if ((blink -> blink_remaining_cycles) == 0) {
+						(blink -> blink_active) = 0;
+					}
+				}
+			}
+			else {
+				// End of on phase.
+				GPIO_Write((blink -> blink_gpio), 0);
+				(blink -> blink_output_state) = 0;
+				(blink -> blink_next_edge_time_ms) += (blink -> blink_off_duration_ms);
+			}
+		}
+		blink = (blink -> blink_next);
+	}
+	BLINK_Schedule();
+}
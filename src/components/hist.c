@@ -0,0 +1,130 @@
+/*
+ * hist.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "hist.h"
+
+#include "nvic.h"
+#include "tcm.h"
+#include "usart.h"
+
+/*** HIST local macros ***/
+
+#define HIST_COUNT_MAX	0xFFFFFFFF // Counters saturate instead of wrapping.
+
+/*** HIST local structures ***/
+
+typedef struct {
+	volatile unsigned int hist_counts[HIST_ID_LAST][HIST_BUCKETS_NUMBER]; // Updated by interrupt handlers.
+	unsigned char hist_dump_active;
+	unsigned char hist_dump_id;
+	unsigned char hist_dump_bucket;
+} HIST_Context;
+
+/*** HIST local global variables ***/
+
+static HIST_Context hist_ctx;
+
+/*** HIST local functions ***/
+
+/* CLEAR ALL HISTOGRAMS.
+ * @param:	None.
+ * @return:	None.
+ */
+void HIST_ClearCounts(void) {
+	unsigned char id = 0;
+	unsigned char bucket = 0;
+	for (id=0 ; id<HIST_ID_LAST ; id++) {
+		for (bucket=0 ; bucket<HIST_BUCKETS_NUMBER ; bucket++) {
+			hist_ctx.hist_counts[id][bucket] = 0;
+		}
+	}
+}
+
+/*** HIST functions ***/
+
+/* INIT HISTOGRAMS.
+ * @param:	None.
+ * @return:	None.
+ */
+void HIST_Init(void) {
+	HIST_ClearCounts();
+	hist_ctx.hist_dump_active = 0;
+	hist_ctx.hist_dump_id = 0;
+	hist_ctx.hist_dump_bucket = 0;
+}
+
+/* ADD A VALUE IN A HISTOGRAM (CALLED BY INTERRUPT HANDLERS AND MAIN LOOP).
+ * @param id:		Histogram identifier.
+ * @param value:	Value to count.
+ * @return:			None.
+ */
+void TCM_ITCM_FUNCTION HIST_Add(HIST_Id id, unsigned int value) {
+	unsigned char bucket = 0;
+	if (id < HIST_ID_LAST) {
+		// Bucket index is the number of significant bits of the value (single CLZ instruction).
+		if (value != 0) {
+			bucket = 32 - __builtin_clz(value);
+		}
+		if (hist_ctx.hist_counts[id][bucket] != HIST_COUNT_MAX) {
+			hist_ctx.hist_counts[id][bucket]++;
+		}
+	}
+}
+
+/* RESET ALL HISTOGRAMS.
+ * @param:	None.
+ * @return:	None.
+ */
+void HIST_Reset(void) {
+	NVIC_MaskAllInterrupts();
+	HIST_ClearCounts();
+	NVIC_UnmaskAllInterrupts();
+}
+
+/* START SENDING ALL HISTOGRAMS ON USART (SENT BY HIST_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void HIST_StartDump(void) {
+	hist_ctx.hist_dump_id = 0;
+	hist_ctx.hist_dump_bucket = 0;
+	hist_ctx.hist_dump_active = 1;
+}
+
+/* MAIN ROUTINE OF HISTOGRAMS.
+ * @param:	None.
+ * @return:	None.
+ */
+void HIST_Task(void) {
+	unsigned int count = 0;
+	if (hist_ctx.hist_dump_active != 0) {
+		// Search next non-empty bucket.
+		while ((hist_ctx.hist_dump_id < HIST_ID_LAST) && (count == 0)) {
+			count = hist_ctx.hist_counts[hist_ctx.hist_dump_id][hist_ctx.hist_dump_bucket];
+			if (count != 0) {
+				// Only one line is sent per call to fit in USART TX buffer: "<id> <bucket> <count>".
+				USART1_SendByte(hist_ctx.hist_dump_id, USART_FORMAT_HEXADECIMAL);
+				USART1_SendByte(' ', USART_FORMAT_ASCII);
+				USART1_SendByte(hist_ctx.hist_dump_bucket, USART_FORMAT_HEXADECIMAL);
+				USART1_SendByte(' ', USART_FORMAT_ASCII);
+				USART1_SendWord(count);
+				USART1_SendByte('\r', USART_FORMAT_ASCII);
+				USART1_SendByte('\n', USART_FORMAT_ASCII);
+			}
+			// Go to next bucket.
+			hist_ctx.hist_dump_bucket++;
+			if (hist_ctx.hist_dump_bucket >= HIST_BUCKETS_NUMBER) {
+				hist_ctx.hist_dump_bucket = 0;
+				hist_ctx.hist_dump_id++;
+			}
+		}
+		if (hist_ctx.hist_dump_id >= HIST_ID_LAST) {
+			// Dump complete.
+			hist_ctx.hist_dump_active = 0;
+		}
+	}
+}
@@ -0,0 +1,165 @@
+/*
+ * load.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "load.h"
+
+#include "dwt.h"
+#include "rcc.h"
+#include "tim.h"
+#include "usart.h"
+
+/*** LOAD local macros ***/
+
+#define LOAD_CALIBRATION_DURATION_MS	10
+#define LOAD_SAMPLE_PERIOD_MS			1000
+#define LOAD_SAMPLES_NUMBER				60 // One sample per second over the longest window.
+#define LOAD_PERMILLE_MAX				1000
+
+/*** LOAD local structures ***/
+
+typedef struct {
+	unsigned int load_run_cycles_per_ms; // Cycles counted in 1ms when the core never sleeps (calibrated with profile clock).
+	unsigned int load_cycles_per_ms; // Same at current core clock.
+	unsigned int load_sample_start_ms;
+	unsigned int load_sample_start_cycles;
+	unsigned int load_sleep_cycles; // Cycles counted in WFI since sample start.
+	unsigned short load_samples_permille[LOAD_SAMPLES_NUMBER];
+	unsigned char load_sample_idx;
+	unsigned char load_samples_count;
+} LOAD_Context;
+
+/*** LOAD local global variables ***/
+
+static LOAD_Context load_ctx;
+static const unsigned char load_window_samples[LOAD_WINDOW_LAST] = {1, 10, 60};
+
+/*** LOAD functions ***/
+
+/* INIT CPU LOAD METER (TIM2 AND DWT MUST BE RUNNING).
+ * @param:	None.
+ * @return:	None.
+ */
+void LOAD_Init(void) {
+	unsigned char idx = 0;
+	unsigned int start_ms = 0;
+	unsigned int start_cycles = 0;
+	// Calibrate baseline with a busy loop.
+	start_ms = TIM2_GetMs();
+	while (TIM2_GetMs() == start_ms); // Synchronize on millisecond edge.
+	start_ms = TIM2_GetMs();
+	start_cycles = DWT_GetCycleCount();
+	while ((TIM2_GetMs() - start_ms) < LOAD_CALIBRATION_DURATION_MS);
+	load_ctx.load_run_cycles_per_ms = (DWT_GetCycleCount() - start_cycles) / LOAD_CALIBRATION_DURATION_MS;
+	load_ctx.load_cycles_per_ms = load_ctx.load_run_cycles_per_ms;
+	// Init samples.
+	for (idx=0 ; idx<LOAD_SAMPLES_NUMBER ; idx++) {
+		load_ctx.load_samples_permille[idx] = 0;
+	}
+	load_ctx.load_sample_idx = 0;
+	load_ctx.load_samples_count = 0;
+	load_ctx.load_sample_start_ms = TIM2_GetMs();
+	load_ctx.load_sample_start_cycles = DWT_GetCycleCount();
+	load_ctx.load_sleep_cycles = 0;
+}
+
+/* TAKE A CORE CLOCK FREQUENCY CHANGE INTO ACCOUNT.
+ * @param:	None.
+ * @return:	None.
+ */
+void LOAD_UpdateClock(void) {
+	// Scale calibration to current clock.
+	load_ctx.load_cycles_per_ms = (unsigned int) ((((unsigned long long) load_ctx.load_run_cycles_per_ms) * RCC_GetSysclkKhz()) / RCC_SYSCLK_KHZ);
+	// Restart current sample since its cycles were counted at previous frequency.
+	load_ctx.load_sample_start_ms = TIM2_GetMs();
+	load_ctx.load_sample_start_cycles = DWT_GetCycleCount();
+	load_ctx.load_sleep_cycles = 0;
+}
+
+/* ADD CYCLES SPENT IN SLEEP MODE (CALLED BY SCHEDULER AROUND WFI).
+ * @param sleep_cycles:	Cycle counter difference measured around WFI instruction.
+ * @return:				None.
+ */
+void LOAD_AddSleepCycles(unsigned int sleep_cycles) {
+	load_ctx.load_sleep_cycles += sleep_cycles;
+}
+
+/* GET CPU LOAD AVERAGED OVER A WINDOW.
+ * @param window:	Averaging window.
+ * @return load:	CPU load in per mille (averaged over available samples during the first minute).
+ */
+unsigned int LOAD_GetPermille(LOAD_Window window) {
+	unsigned int load_sum = 0;
+	unsigned char samples_number = 0;
+	unsigned char sample_idx = load_ctx.load_sample_idx;
+	unsigned char idx = 0;
+	if (window < LOAD_WINDOW_LAST) {
+		samples_number = load_window_samples[window];
+		if (samples_number > load_ctx.load_samples_count) {
+			samples_number = load_ctx.load_samples_count;
+		}
+		// Sum most recent samples.
+		for (idx=0 ; idx<samples_number ; idx++) {
+			sample_idx = (sample_idx == 0) ? (LOAD_SAMPLES_NUMBER - 1) : (sample_idx - 1);
+			load_sum += load_ctx.load_samples_permille[sample_idx];
+		}
+		if (samples_number != 0) {
+			load_sum /= samples_number;
+		}
+	}
+	return load_sum;
+}
+
+/* SEND CPU LOAD ON USART: "<1s> <10s> <60s>" IN PER MILLE.
+ * @param:	None.
+ * @return:	None.
+ */
+void LOAD_Send(void) {
+	USART1_SendWord(LOAD_GetPermille(LOAD_WINDOW_1S));
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(LOAD_GetPermille(LOAD_WINDOW_10S));
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(LOAD_GetPermille(LOAD_WINDOW_60S));
+	USART1_SendByte('\r', USART_FORMAT_ASCII);
+	USART1_SendByte('\n', USART_FORMAT_ASCII);
+}
+
+/* MAIN ROUTINE OF CPU LOAD METER.
+ * @param:	None.
+ * @return:	None.
+ */
+void LOAD_Task(void) {
+	unsigned int now_ms = TIM2_GetMs();
+	unsigned int now_cycles = 0;
+	unsigned int active_cycles = 0;
+	unsigned int elapsed_ms = now_ms - load_ctx.load_sample_start_ms;
+	unsigned long long load_permille = 0;
+	if (elapsed_ms >= LOAD_SAMPLE_PERIOD_MS) {
+		// Sleep cycles are removed whether or not the cycle counter runs while the core sleeps (depends on debug configuration).
+		now_cycles = DWT_GetCycleCount();
+		active_cycles = (now_cycles - load_ctx.load_sample_start_cycles);
+		active_cycles = (active_cycles > load_ctx.load_sleep_cycles) ? (active_cycles - load_ctx.load_sleep_cycles) : 0;
+		// Compare to the cycles of a fully loaded core over the same duration.
+		load_permille = ((unsigned long long) active_cycles) * LOAD_PERMILLE_MAX;
+		load_permille /= ((unsigned long long) load_ctx.load_cycles_per_ms) * elapsed_ms;
+		if (load_permille > LOAD_PERMILLE_MAX) {
+			load_permille = LOAD_PERMILLE_MAX;
+		}
+		// Store sample.
+		load_ctx.load_samples_permille[load_ctx.load_sample_idx] = (unsigned short) load_permille;
+		load_ctx.load_sample_idx++;
+		if (load_ctx.load_sample_idx >= LOAD_SAMPLES_NUMBER) {
+			load_ctx.load_sample_idx = 0;
+		}
+		if (load_ctx.load_samples_count < LOAD_SAMPLES_NUMBER) {
+			load_ctx.load_samples_count++;
+		}
+		// Start next sample.
+		load_ctx.load_sample_start_ms = now_ms;
+		load_ctx.load_sample_start_cycles = now_cycles;
+		load_ctx.load_sleep_cycles = 0;
+	}
+}
@@ -0,0 +1,158 @@
+/*
+ * pcs.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "pcs.h"
+
+#ifdef PCS_ENABLED
+
+#include "rcc.h"
+#include "systick.h"
+#include "usart.h"
+
+/*** PCS local macros ***/
+
+#define PCS_SAMPLING_FREQUENCY_HZ	1999 // Not a multiple of tasks and timers frequencies to avoid aliasing.
+#define PCS_COUNT_MAX				0xFFFFFFFF
+#define PCS_DUMP_LINES_PER_CALL		3 // 3 lines of 15 characters are sent in 47ms at 9600 bauds.
+#define PCS_DUMP_OUTSIDE_BUCKET		0xFFFF // Bucket index used to send the number of samples outside code range.
+
+/*** PCS local structures ***/
+
+typedef struct {
+	volatile unsigned int pcs_counts[PCS_BUCKETS_NUMBER];
+	volatile unsigned int pcs_outside_count; // Samples outside code ranges (RAM or system memory).
+	unsigned char pcs_dump_active;
+	unsigned int pcs_dump_bucket;
+} PCS_Context;
+
+/*** PCS local global variables ***/
+
+static PCS_Context pcs_ctx;
+
+/*** PCS local functions ***/
+
+/* CLEAR ALL SAMPLES.
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_ClearCounts(void) {
+	unsigned int bucket = 0;
+	for (bucket=0 ; bucket<PCS_BUCKETS_NUMBER ; bucket++) {
+		pcs_ctx.pcs_counts[bucket] = 0;
+	}
+	pcs_ctx.pcs_outside_count = 0;
+}
+
+/* SEND ONE DUMP LINE: "<bucket> <count>".
+ * @param bucket:	Bucket index.
+ * @param count:	Number of samples.
+ * @return:			None.
+ */
+void PCS_SendLine(unsigned int bucket, unsigned int count) {
+	USART1_SendByte(((bucket >> 8) & 0xFF), USART_FORMAT_HEXADECIMAL);
+	USART1_SendByte((bucket & 0xFF), USART_FORMAT_HEXADECIMAL);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(count);
+	USART1_SendByte('\r', USART_FORMAT_ASCII);
+	USART1_SendByte('\n', USART_FORMAT_ASCII);
+}
+
+/*** PCS functions ***/
+
+/* INIT AND START PC SAMPLING.
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_Init(void) {
+	PCS_ClearCounts();
+	pcs_ctx.pcs_dump_active = 0;
+	pcs_ctx.pcs_dump_bucket = 0;
+	SYSTICK_Init((RCC_GetSysclkKhz() * 1000) / PCS_SAMPLING_FREQUENCY_HZ);
+	SYSTICK_Start();
+}
+
+/* KEEP SAMPLING FREQUENCY AFTER A CORE CLOCK FREQUENCY CHANGE.
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_UpdateClock(void) {
+	SYSTICK_Init((RCC_GetSysclkKhz() * 1000) / PCS_SAMPLING_FREQUENCY_HZ);
+	// Sampling is stopped during dump.
+	if (pcs_ctx.pcs_dump_active == 0) {
+		SYSTICK_Start();
+	}
+}
+
+/* COUNT AN INTERRUPTED PROGRAM COUNTER (CALLED BY SYSTICK INTERRUPT HANDLER).
+ * @param pc:	Program counter read in the exception stack frame.
+ * @return:		None.
+ */
+void PCS_Sample(unsigned int pc) {
+	unsigned int bucket = ((pc - PCS_CODE_BASE_ADDRESS) >> PCS_BUCKET_SIZE_SHIFT);
+	// Addresses below code base wrap to a high bucket index.
+	if (bucket >= PCS_CODE_BUCKETS_NUMBER) {
+		// Interrupt handlers and hot functions run from ITCM.
+		bucket = ((pc - PCS_ITCM_BASE_ADDRESS) >> PCS_BUCKET_SIZE_SHIFT);
+		bucket = (bucket < PCS_ITCM_BUCKETS_NUMBER) ? (PCS_CODE_BUCKETS_NUMBER + bucket) : PCS_BUCKETS_NUMBER;
+	}
+	if (bucket < PCS_BUCKETS_NUMBER) {
+		if (pcs_ctx.pcs_counts[bucket] != PCS_COUNT_MAX) {
+			pcs_ctx.pcs_counts[bucket]++;
+		}
+	}
+	else {
+		pcs_ctx.pcs_outside_count++;
+	}
+}
+
+/* CLEAR ALL SAMPLES AND RESTART SAMPLING.
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_Reset(void) {
+	SYSTICK_Stop();
+	PCS_ClearCounts();
+	pcs_ctx.pcs_dump_active = 0;
+	SYSTICK_Start();
+}
+
+/* STOP SAMPLING AND START SENDING ALL NON-EMPTY BUCKETS ON USART (SENT BY PCS_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_StartDump(void) {
+	// Sampling is stopped to get a consistent snapshot.
+	SYSTICK_Stop();
+	pcs_ctx.pcs_dump_bucket = 0;
+	pcs_ctx.pcs_dump_active = 1;
+}
+
+/* MAIN ROUTINE OF PC SAMPLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void PCS_Task(void) {
+	unsigned char lines_count = 0;
+	if (pcs_ctx.pcs_dump_active != 0) {
+		// Send a few non-empty buckets per call to fit in USART TX buffer.
+		while ((pcs_ctx.pcs_dump_bucket < PCS_BUCKETS_NUMBER) && (lines_count < PCS_DUMP_LINES_PER_CALL)) {
+			if (pcs_ctx.pcs_counts[pcs_ctx.pcs_dump_bucket] != 0) {
+				PCS_SendLine(pcs_ctx.pcs_dump_bucket, pcs_ctx.pcs_counts[pcs_ctx.pcs_dump_bucket]);
+				lines_count++;
+			}
+			pcs_ctx.pcs_dump_bucket++;
+		}
+		if ((pcs_ctx.pcs_dump_bucket >= PCS_BUCKETS_NUMBER) && (lines_count < PCS_DUMP_LINES_PER_CALL)) {
+			// Dump complete, resume sampling.
+			PCS_SendLine(PCS_DUMP_OUTSIDE_BUCKET, pcs_ctx.pcs_outside_count);
+			pcs_ctx.pcs_dump_active = 0;
+			SYSTICK_Start();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * prof.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "prof.h"
+
+#ifdef PROF_ENABLED
+
+#include "dwt.h"
+#include "nvic.h"
+#include "usart.h"
+
+/*** PROF local structures ***/
+
+typedef struct {
+	unsigned int prof_start_cycles;
+	unsigned int prof_count;
+	unsigned int prof_min_cycles;
+	unsigned int prof_max_cycles;
+	unsigned long long prof_total_cycles;
+} PROF_Entry;
+
+typedef struct {
+	PROF_Entry prof_entries[PROF_ID_LAST];
+	unsigned int prof_overhead_cycles; // Cost of an empty start/stop pair, removed from each measure.
+	unsigned char prof_dump_active;
+	unsigned char prof_dump_idx;
+} PROF_Context;
+
+/*** PROF local global variables ***/
+
+static PROF_Context prof_ctx;
+
+/*** PROF local functions ***/
+
+/* CLEAR THE STATISTICS OF ALL SECTIONS.
+ * @param:	None.
+ * @return:	None.
+ */
+void PROF_ClearEntries(void) {
+	unsigned char idx = 0;
+	for (idx=0 ; idx<PROF_ID_LAST ; idx++) {
+		prof_ctx.prof_entries[idx].prof_start_cycles = 0;
+		prof_ctx.prof_entries[idx].prof_count = 0;
+		prof_ctx.prof_entries[idx].prof_min_cycles = 0xFFFFFFFF;
+		prof_ctx.prof_entries[idx].prof_max_cycles = 0;
+		prof_ctx.prof_entries[idx].prof_total_cycles = 0;
+	}
+}
+
+/*** PROF functions ***/
+
+/* INIT PROFILER.
+ * @param:	None.
+ * @return:	None.
+ */
+void PROF_Init(void) {
+	// Measure probes overhead on a dummy section.
+	prof_ctx.prof_overhead_cycles = 0;
+	PROF_ClearEntries();
+	PROF_Start(PROF_ID_TASK);
+	PROF_Stop(PROF_ID_TASK);
+	prof_ctx.prof_overhead_cycles = prof_ctx.prof_entries[PROF_ID_TASK].prof_max_cycles;
+	PROF_ClearEntries();
+	prof_ctx.prof_dump_active = 0;
+	prof_ctx.prof_dump_idx = 0;
+}
+
+/* START MEASURING A SECTION.
+ * @param id:	Section identifier.
+ * @return:		None.
+ */
+void PROF_Start(PROF_Id id) {
+	if (id < PROF_ID_LAST) {
+		prof_ctx.prof_entries[id].prof_start_cycles = DWT_GetCycleCount();
+	}
+}
+
+/* STOP MEASURING A SECTION AND UPDATE ITS STATISTICS.
+ * @param id:	Section identifier.
+ * @return:		None.
+ */
+void PROF_Stop(PROF_Id id) {
+	unsigned int cycles = 0;
+	PROF_Entry* entry = 0;
+	if (id < PROF_ID_LAST) {
+		entry = &(prof_ctx.prof_entries[id]);
+		// Tasks measures include the interrupts which preempted them.
+		cycles = DWT_GetCycleCount() - (entry -> prof_start_cycles);
+		cycles = (cycles > prof_ctx.prof_overhead_cycles) ? (cycles - prof_ctx.prof_overhead_cycles) : 0;
+		if (cycles < (entry -> prof_min_cycles)) {
+			entry -> prof_min_cycles = cycles;
+		}
+		if (cycles > (entry -> prof_max_cycles)) {
+			entry -> prof_max_cycles = cycles;
+		}
+		entry -> prof_total_cycles += cycles;
+		entry -> prof_count++;
+	}
+}
+
+/* RESET ALL STATISTICS.
+ * @param:	None.
+ * @return:	None.
+ */
+void PROF_Reset(void) {
+	NVIC_MaskAllInterrupts();
+	PROF_ClearEntries();
+	NVIC_UnmaskAllInterrupts();
+}
+
+/* START SENDING ALL STATISTICS ON USART (SENT BY PROF_Task).
+ * @param:	None.
+ * @return:	None.
+ */
+void PROF_StartDump(void) {
+	prof_ctx.prof_dump_idx = 0;
+	prof_ctx.prof_dump_active = 1;
+}
+
+/* MAIN ROUTINE OF PROFILER.
+ * @param:	None.
+ * @return:	None.
+ */
+void PROF_Task(void) {
+	PROF_Entry entry;
+	unsigned int avg_cycles = 0;
+	if (prof_ctx.prof_dump_active != 0) {
+		// Skip sections which never ran.
+		while ((prof_ctx.prof_dump_idx < PROF_ID_LAST) && (prof_ctx.prof_entries[prof_ctx.prof_dump_idx].prof_count == 0)) {
+			prof_ctx.prof_dump_idx++;
+		}
+		if (prof_ctx.prof_dump_idx < PROF_ID_LAST) {
+			// Copy entry since it may be updated by an interrupt.
+			NVIC_MaskAllInterrupts();
+			entry = prof_ctx.prof_entries[prof_ctx.prof_dump_idx];
+			NVIC_UnmaskAllInterrupts();
+			avg_cycles = (unsigned int) ((entry.prof_total_cycles) / (entry.prof_count));
+			// Only one line is sent per call to fit in USART TX buffer: "<id> <min> <avg> <max> <count>".
+			USART1_SendByte(prof_ctx.prof_dump_idx, USART_FORMAT_HEXADECIMAL);
+			USART1_SendByte(' ', USART_FORMAT_ASCII);
+			USART1_SendWord(entry.prof_min_cycles);
+			USART1_SendByte(' ', USART_FORMAT_ASCII);
+			USART1_SendWord(avg_cycles);
+			USART1_SendByte(' ', USART_FORMAT_ASCII);
+			USART1_SendWord(entry.prof_max_cycles);
+			USART1_SendByte(' ', USART_FORMAT_ASCII);
+			USART1_SendWord(entry.prof_count);
+			USART1_SendByte('\r', USART_FORMAT_ASCII);
+			USART1_SendByte('\n', USART_FORMAT_ASCII);
+			prof_ctx.prof_dump_idx++;
+		}
+		else {
+			// Dump complete.
+			prof_ctx.prof_dump_active = 0;
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * pwrm.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "pwrm.h"
+
+#include "adc.h"
+#include "common.h"
+#include "dwt.h"
+#include "load.h"
+#include "pcs.h"
+#include "rcc.h"
+#include "tim.h"
+#include "usart.h"
+
+/*** PWRM local structures ***/
+
+typedef enum {
+	PWRM_STATE_RUN,
+	PWRM_STATE_STANDBY
+} PWRM_State;
+
+typedef struct {
+	PWRM_State pwrm_state;
+	unsigned char pwrm_clock_scaling_enabled; // Cleared when a resume exceeds PWRM_RESUME_DURATION_MAX_US.
+	unsigned char pwrm_clock_scaled; // Standby clock is currently used.
+	// Statistics.
+	unsigned int pwrm_standby_count;
+	unsigned int pwrm_resume_duration_us_max;
+	unsigned int pwrm_resume_overrun_count;
+} PWRM_Context;
+
+/*** PWRM local global variables ***/
+
+static PWRM_Context pwrm_ctx;
+
+/*** PWRM local functions ***/
+
+/* REPROGRAM CLOCK DEPENDENT PERIPHERALS WHICH KEEP RUNNING IN STANDBY (TIM2 IS UPDATED DURING THE SWITCH ITSELF
+ * AND USART1 IS CLOCKED BY HSI).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_UpdateClocks(void) {
+	LOAD_UpdateClock();
+#ifdef PCS_ENABLED
+	PCS_UpdateClock();
+#endif
+}
+
+/* CHECK IF PERIPHERALS GATED IN STANDBY ARE ALL STOPPED.
+ * @param:	None.
+ * @return:	'1' if standby can be entered, '0' otherwise.
+ */
+unsigned char PWRM_DashboardIsIdle(void) {
+	unsigned char running = 0;
+	running |= TIM5_IsRunning(); // Tachro.
+	running |= TIM6_IsRunning(); // KVB sweep.
+	running |= TIM7_IsRunning(); // Manometers.
+	running |= TIM8_IsRunning(); // LVAL.
+	running |= ADC1_IsRunning();
+	return ((running == 0) ? 1 : 0);
+}
+
+/* GATE DASHBOARD PERIPHERALS AND SWITCH TO STANDBY CLOCK.
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_EnterStandby(void) {
+	RCC_EnableDashboardClocks(0);
+	if (pwrm_ctx.pwrm_clock_scaling_enabled != 0) {
+		TIM2_SwitchClock(&RCC_SwitchToStandbyClock);
+		RCC_DisableRunPll();
+		PWRM_UpdateClocks();
+		pwrm_ctx.pwrm_clock_scaled = 1;
+	}
+	pwrm_ctx.pwrm_standby_count++;
+	pwrm_ctx.pwrm_state = PWRM_STATE_STANDBY;
+}
+
+/*** PWRM functions ***/
+
+/* INIT POWER MANAGER (DWT MUST BE RUNNING).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_Init(void) {
+	pwrm_ctx.pwrm_state = PWRM_STATE_RUN;
+	pwrm_ctx.pwrm_clock_scaling_enabled = 1;
+	pwrm_ctx.pwrm_clock_scaled = 0;
+	pwrm_ctx.pwrm_standby_count = 0;
+	pwrm_ctx.pwrm_resume_duration_us_max = 0;
+	pwrm_ctx.pwrm_resume_overrun_count = 0;
+}
+
+/* RESTORE PROFILE CLOCKS AND DASHBOARD PERIPHERALS (MUST BE CALLED BEFORE USING TIM5/6/7/8, ADC OR DAC).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_Wake(void) {
+	unsigned int start_cycles = 0;
+	unsigned int duration_us = 0;
+	if (pwrm_ctx.pwrm_state == PWRM_STATE_STANDBY) {
+		start_cycles = DWT_GetCycleCount();
+		if (pwrm_ctx.pwrm_clock_scaled != 0) {
+			// Cycles are counted at standby clock until PLL is selected.
+			RCC_EnableRunPll();
+			TIM2_SwitchClock(&RCC_SwitchToRunClock);
+			duration_us = (DWT_GetCycleCount() - start_cycles) / (RCC_STANDBY_SYSCLK_KHZ / 1000);
+			start_cycles = DWT_GetCycleCount();
+			PWRM_UpdateClocks();
+			pwrm_ctx.pwrm_clock_scaled = 0;
+		}
+		RCC_EnableDashboardClocks(1);
+		duration_us += (DWT_GetCycleCount() - start_cycles) / (RCC_SYSCLK_KHZ / 1000);
+		pwrm_ctx.pwrm_state = PWRM_STATE_RUN;
+		// Update statistics and check bound.
+		if (duration_us > pwrm_ctx.pwrm_resume_duration_us_max) {
+			pwrm_ctx.pwrm_resume_duration_us_max = duration_us;
+		}
+		if (duration_us > PWRM_RESUME_DURATION_MAX_US) {
+			pwrm_ctx.pwrm_resume_overrun_count++;
+			pwrm_ctx.pwrm_clock_scaling_enabled = 0;
+		}
+	}
+}
+
+/* SEND POWER MANAGER STATISTICS ON USART: "<standby entries> <max resume duration in us> <resume overruns>".
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_Send(void) {
+	USART1_SendWord(pwrm_ctx.pwrm_standby_count);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(pwrm_ctx.pwrm_resume_duration_us_max);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(pwrm_ctx.pwrm_resume_overrun_count);
+	USART1_SendByte('\r', USART_FORMAT_ASCII);
+	USART1_SendByte('\n', USART_FORMAT_ASCII);
+}
+
+/* MAIN ROUTINE OF POWER MANAGER.
+ * @param:	None.
+ * @return:	None.
+ */
+void PWRM_Task(void) {
+	switch (pwrm_ctx.pwrm_state) {
+	case PWRM_STATE_RUN:
+		// Enter standby once the cab is off and the dashboard peripherals have been stopped by their modules.
+		if ((lsmcu_ctx.lsmcu_zba_closed == 0) && (PWRM_DashboardIsIdle() != 0)) {
+			PWRM_EnterStandby();
+		}
+		break;
+	case PWRM_STATE_STANDBY:
+		// ZBA module wakes the power manager before setting the flag, this is a fallback.
+		if (lsmcu_ctx.lsmcu_zba_closed != 0) {
+			PWRM_Wake();
+		}
+		break;
+	default:
+		// Unknown state.
+		PWRM_Wake();
+		pwrm_ctx.pwrm_state = PWRM_STATE_RUN;
+		break;
+	}
+}
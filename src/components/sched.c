@@ -0,0 +1,220 @@
+/*
+ * sched.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "sched.h"
+
+#include "dwt.h"
+#include "load.h"
+#include "nvic.h"
+#include "prof.h"
+#include "pwr.h"
+#include "tcm.h"
+#include "tim.h"
+
+/*** SCHED local macros ***/
+
+#define SCHED_WAKE_UP_DELAY_MAX_MS	0x7FFFFFFF	// Used when no periodic task is registered.
+
+/*** SCHED local structures ***/
+
+typedef struct {
+	SCHED_Task sched_tasks[SCHED_TASKS_NUMBER_MAX]; // Sorted by priority.
+	unsigned char sched_tasks_count;
+	volatile unsigned char sched_events[SCHED_EVENT_LAST]; // One byte per event so that posting is a single store.
+} SCHED_Context;
+
+/*** SCHED local global variables ***/
+
+static SCHED_Context sched_ctx TCM_DTCM_DATA;
+
+/*** SCHED local functions ***/
+
+/* CALL A TASK AND UPDATE ITS STATISTICS.
+ * @param task_idx:	Index of the task in scheduler table.
+ * @return:			None.
+ */
+void SCHED_CallTask(unsigned char task_idx) {
+	PROF_START(PROF_ID_TASK + task_idx);
+	(sched_ctx.sched_tasks[task_idx].sched_task)();
+	PROF_STOP(PROF_ID_TASK + task_idx);
+	sched_ctx.sched_tasks[task_idx].sched_run_count++;
+}
+
+/*** SCHED functions ***/
+
+/* INIT TASK SCHEDULER.
+ * @param:	None.
+ * @return:	None.
+ */
+void SCHED_Init(void) {
+	unsigned char event_idx = 0;
+	sched_ctx.sched_tasks_count = 0;
+	for (event_idx=0 ; event_idx<SCHED_EVENT_LAST ; event_idx++) {
+		sched_ctx.sched_events[event_idx] = 0;
+	}
+}
+
+/* ADD A TASK TO THE SCHEDULER.
+ * @param task:			Function to call.
+ * @param period_ms:	Period of the task in ms (0 to run it only on event, or on every scheduler pass if event is SCHED_EVENT_NONE).
+ * @param event:		Event which also triggers the task (SCHED_EVENT_NONE if not used).
+ * @param priority:		Order in which due tasks are run (lowest value first, tasks with the same priority are run in registration order).
+ * @return:				None.
+ */
+void SCHED_Register(void (*task)(void), unsigned int period_ms, SCHED_Event event, unsigned char priority) {
+	unsigned char task_idx = sched_ctx.sched_tasks_count;
+	// Check table size.
+	if (sched_ctx.sched_tasks_count < SCHED_TASKS_NUMBER_MAX) {
+		// Shift lower priority tasks.
+		while ((task_idx > 0) && (sched_ctx.sched_tasks[task_idx - 1].sched_priority > priority)) {
+			sched_ctx.sched_tasks[task_idx] = sched_ctx.sched_tasks[task_idx - 1];
+			task_idx--;
+		}
+		// Insert new task (first run on next scheduler pass).
+		sched_ctx.sched_tasks[task_idx].sched_task = task;
+		sched_ctx.sched_tasks[task_idx].sched_period_ms = period_ms;
+		sched_ctx.sched_tasks[task_idx].sched_event = (event < SCHED_EVENT_LAST) ? event : SCHED_EVENT_NONE;
+		sched_ctx.sched_tasks[task_idx].sched_priority = priority;
+		sched_ctx.sched_tasks[task_idx].sched_next_run_time_ms = TIM2_GetMs();
+		sched_ctx.sched_tasks[task_idx].sched_run_count = 0;
+		sched_ctx.sched_tasks[task_idx].sched_overrun_count = 0;
+		sched_ctx.sched_tasks_count++;
+	}
+}
+
+/* POST AN EVENT (CALLED BY INTERRUPT HANDLERS).
+ * @param event:	Event to post.
+ * @return:			None.
+ */
+void TCM_ITCM_FUNCTION SCHED_PostEvent(SCHED_Event event) {
+	if (event < SCHED_EVENT_LAST) {
+		sched_ctx.sched_events[event] = 1;
+	}
+}
+
+/* GET THE NUMBER OF REGISTERED TASKS.
+ * @param:			None.
+ * @return count:	Number of tasks in scheduler table.
+ */
+unsigned char SCHED_GetTaskCount(void) {
+	return sched_ctx.sched_tasks_count;
+}
+
+/* GET A TASK DESCRIPTOR AND ITS STATISTICS.
+ * @param task_idx:	Index of the task in scheduler table (by priority order).
+ * @return task:	Pointer to the task descriptor, 0 if index is out of range.
+ */
+const SCHED_Task* SCHED_GetTask(unsigned char task_idx) {
+	const SCHED_Task* task = 0;
+	if (task_idx < sched_ctx.sched_tasks_count) {
+		task = &(sched_ctx.sched_tasks[task_idx]);
+	}
+	return task;
+}
+
+/* RUN ALL DUE TASKS (TO BE CALLED IN MAIN LOOP).
+ * @param:	None.
+ * @return:	None.
+ */
+void SCHED_Run(void) {
+	unsigned char task_idx = 0;
+	unsigned char event_posted = 0;
+	unsigned int now_ms = TIM2_GetMs();
+	SCHED_Task* task = 0;
+	for (task_idx=0 ; task_idx<sched_ctx.sched_tasks_count ; task_idx++) {
+		task = &(sched_ctx.sched_tasks[task_idx]);
+		// Consume event before running the task so that an event posted meanwhile is not lost.
+		event_posted = 0;
+		if (((task -> sched_event) != SCHED_EVENT_NONE) && (sched_ctx.sched_events[task -> sched_event] != 0)) {
+			sched_ctx.sched_events[task -> sched_event] = 0;
+			event_posted = 1;
+		}
+		if ((task -> sched_period_ms) == 0) {
+			// Task runs on every pass if it is not triggered by an event.
+			if ((event_posted != 0) || ((task -> sched_event) == SCHED_EVENT_NONE)) {
+				SCHED_CallTask(task_idx);
+			}
+		}
+		else {
+			// Check deadline (wrap-safe).
+			if (((int) (now_ms - (task -> sched_next_run_time_ms))) >= 0) {
+				SCHED_CallTask(task_idx);
+				// Compute next deadline.
+				if ((now_ms - (task -> sched_next_run_time_ms)) >= (task -> sched_period_ms)) {
+					// At least one period was missed, resynchronize on current time.
+					task -> sched_overrun_count++;
+					task -> sched_next_run_time_ms = now_ms + (task -> sched_period_ms);
+				}
+				else {
+					task -> sched_next_run_time_ms += (task -> sched_period_ms);
+				}
+			}
+			else {
+				// Event occurred before deadline.
+				if (event_posted != 0) {
+					SCHED_CallTask(task_idx);
+				}
+			}
+		}
+	}
+}
+
+/* ENTER SLEEP MODE UNTIL NEXT EVENT OR TASK DEADLINE (TO BE CALLED IN MAIN LOOP AFTER SCHED_Run).
+ * @param:	None.
+ * @return:	None.
+ */
+void SCHED_Sleep(void) {
+	unsigned char idx = 0;
+	unsigned char sleep_allowed = 1;
+	unsigned int now_ms = TIM2_GetMs();
+	int wake_up_delay_ms = SCHED_WAKE_UP_DELAY_MAX_MS;
+	int task_delay_ms = 0;
+	unsigned int sleep_start_cycles = 0;
+	// Search nearest deadline.
+	for (idx=0 ; idx<sched_ctx.sched_tasks_count ; idx++) {
+		if ((sched_ctx.sched_tasks[idx].sched_period_ms) == 0) {
+			// Tasks run on every pass prevent sleeping.
+			if ((sched_ctx.sched_tasks[idx].sched_event) == SCHED_EVENT_NONE) {
+				sleep_allowed = 0;
+			}
+		}
+		else {
+			task_delay_ms = (int) ((sched_ctx.sched_tasks[idx].sched_next_run_time_ms) - now_ms);
+			if (task_delay_ms < wake_up_delay_ms) {
+				wake_up_delay_ms = task_delay_ms;
+			}
+		}
+	}
+	if (wake_up_delay_ms <= 0) {
+		sleep_allowed = 0;
+	}
+	if (sleep_allowed != 0) {
+		// Interrupts are masked until WFI so that an event posted after this check wakes the core up instead of being missed.
+		NVIC_MaskAllInterrupts();
+		for (idx=0 ; idx<SCHED_EVENT_LAST ; idx++) {
+			if (sched_ctx.sched_events[idx] != 0) {
+				sleep_allowed = 0;
+			}
+		}
+		if (sleep_allowed != 0) {
+			if (wake_up_delay_ms != SCHED_WAKE_UP_DELAY_MAX_MS) {
+				TIM2_SetWakeUpMs(now_ms + wake_up_delay_ms);
+				// Deadline may have been reached before compare register was written.
+				if (((int) (TIM2_GetMs() - (now_ms + wake_up_delay_ms))) >= 0) {
+					sleep_allowed = 0;
+				}
+			}
+			if (sleep_allowed != 0) {
+				sleep_start_cycles = DWT_GetCycleCount();
+				PWR_EnterSleepMode();
+				LOAD_AddSleepCycles(DWT_GetCycleCount() - sleep_start_cycles);
+			}
+		}
+		// Pending interrupts are executed here.
+		NVIC_UnmaskAllInterrupts();
+	}
+}
@@ -0,0 +1,136 @@
+/*
+ * sig.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "sig.h"
+
+#include "sched.h"
+#include "tim.h"
+#include "usart.h"
+
+/*** SIG local structures ***/
+
+typedef struct {
+	const unsigned char* sig_signal; // Shared field watched by the subscriber.
+	void (*sig_handler)(void);
+	unsigned char sig_pending;
+} SIG_Subscriber;
+
+typedef struct {
+	SIG_Subscriber sig_subscribers[SIG_SUBSCRIBERS_NUMBER_MAX];
+	unsigned char sig_subscribers_count;
+	unsigned char sig_handlers_count; // Distinct handlers.
+	// Statistics: handlers are only run on change instead of polling the signals on every pass.
+	unsigned int sig_write_count;
+	unsigned int sig_change_count;
+	unsigned int sig_handler_count;
+	unsigned int sig_polling_period_ms; // Period at which the handlers would run if the signals were polled.
+	unsigned int sig_start_ms;
+} SIG_Context;
+
+/*** SIG local global variables ***/
+
+static SIG_Context sig_ctx;
+
+/*** SIG functions ***/
+
+/* INIT SIGNAL BUS.
+ * @param polling_period_ms:	Period of the tasks which polled the signals before (used to compare statistics).
+ * @return:						None.
+ */
+void SIG_Init(unsigned int polling_period_ms) {
+	sig_ctx.sig_subscribers_count = 0;
+	sig_ctx.sig_handlers_count = 0;
+	sig_ctx.sig_write_count = 0;
+	sig_ctx.sig_change_count = 0;
+	sig_ctx.sig_handler_count = 0;
+	sig_ctx.sig_polling_period_ms = (polling_period_ms != 0) ? polling_period_ms : 1;
+	sig_ctx.sig_start_ms = TIM2_GetMs();
+}
+
+/* CALL A HANDLER EACH TIME A SIGNAL CHANGES.
+ * @param signal:	Pointer to the shared field.
+ * @param handler:	Function to call (from SIG_Task) when the field changes.
+ * @return:			None.
+ */
+void SIG_Subscribe(const unsigned char* signal, void (*handler)(void)) {
+	unsigned char idx = 0;
+	unsigned char new_handler = 1;
+	// Check table size.
+	if (sig_ctx.sig_subscribers_count < SIG_SUBSCRIBERS_NUMBER_MAX) {
+		for (idx=0 ; idx<sig_ctx.sig_subscribers_count ; idx++) {
+			if (sig_ctx.sig_subscribers[idx].sig_handler == handler) {
+				new_handler = 0;
+			}
+		}
+		sig_ctx.sig_handlers_count += new_handler;
+		sig_ctx.sig_subscribers[sig_ctx.sig_subscribers_count].sig_signal = signal;
+		sig_ctx.sig_subscribers[sig_ctx.sig_subscribers_count].sig_handler = handler;
+		sig_ctx.sig_subscribers[sig_ctx.sig_subscribers_count].sig_pending = 0;
+		sig_ctx.sig_subscribers_count++;
+	}
+}
+
+/* WRITE A SIGNAL AND NOTIFY ITS SUBSCRIBERS IF THE VALUE CHANGED.
+ * @param signal:	Pointer to the shared field.
+ * @param value:	New value.
+ * @return:			None.
+ */
+void SIG_Write(unsigned char* signal, unsigned char value) {
+	unsigned char idx = 0;
+	sig_ctx.sig_write_count++;
+	if ((*signal) != value) {
+		(*signal) = value;
+		sig_ctx.sig_change_count++;
+		// Mark subscribers.
+		for (idx=0 ; idx<sig_ctx.sig_subscribers_count ; idx++) {
+			if (sig_ctx.sig_subscribers[idx].sig_signal == signal) {
+				sig_ctx.sig_subscribers[idx].sig_pending = 1;
+				SCHED_PostEvent(SCHED_EVENT_SIGNAL);
+			}
+		}
+	}
+}
+
+/* SEND SIGNAL BUS STATISTICS ON USART: "<writes> <changes> <handlers calls> <handlers calls with polling>".
+ * @param:	None.
+ * @return:	None.
+ */
+void SIG_Send(void) {
+	// Polling runs every handler once per period.
+	unsigned int polling_count = ((TIM2_GetMs() - sig_ctx.sig_start_ms) / sig_ctx.sig_polling_period_ms) * sig_ctx.sig_handlers_count;
+	USART1_SendWord(sig_ctx.sig_write_count);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(sig_ctx.sig_change_count);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(sig_ctx.sig_handler_count);
+	USART1_SendByte(' ', USART_FORMAT_ASCII);
+	USART1_SendWord(polling_count);
+	USART1_SendByte('\r', USART_FORMAT_ASCII);
+	USART1_SendByte('\n', USART_FORMAT_ASCII);
+}
+
+/* RUN THE HANDLERS OF CHANGED SIGNALS (SCHEDULED ON SCHED_EVENT_SIGNAL).
+ * @param:	None.
+ * @return:	None.
+ */
+void SIG_Task(void) {
+	unsigned char idx = 0;
+	unsigned char other_idx = 0;
+	for (idx=0 ; idx<sig_ctx.sig_subscribers_count ; idx++) {
+		if (sig_ctx.sig_subscribers[idx].sig_pending != 0) {
+			// A handler subscribed to several changed signals is only called once.
+			for (other_idx=idx ; other_idx<sig_ctx.sig_subscribers_count ; other_idx++) {
+				if (sig_ctx.sig_subscribers[other_idx].sig_handler == sig_ctx.sig_subscribers[idx].sig_handler) {
+					sig_ctx.sig_subscribers[other_idx].sig_pending = 0;
+				}
+			}
+			// Handler may write signals, which marks subscribers again for the next call.
+			(sig_ctx.sig_subscribers[idx].sig_handler)();
+			sig_ctx.sig_handler_count++;
+		}
+	}
+}
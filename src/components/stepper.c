@@ -8,6 +8,27 @@
 #include "stepper.h"
 
 #include "gpio.h"
+#include "tcm.h"
+
+/*** STEPPER local structures ***/
+
+typedef struct {
+	GPIO_BaseAddress* port_address;
+	unsigned int port_bsrr; // Pending BSRR word.
+} STEPPER_Port;
+
+typedef struct {
+	STEPPER_Port stepper_ports[STEPPER_PORTS_MAX];
+	unsigned char stepper_ports_count;
+	unsigned char stepper_batch_active;
+} STEPPER_Batch;
+
+/*** STEPPER local global variables ***/
+
+// Pins state of each full step phase (bit 1 = motor pin 1, bit 0 = motor pin 2).
+static const unsigned char stepper_phase_table[4] = {0b00, 0b01, 0b11, 0b10};
+// Ports writes combined between STEPPER_StartBatch() and STEPPER_EndBatch().
+static STEPPER_Batch stepper_batch TCM_DTCM_DATA;
 
 /*** STEPPER local functions ***/
 
@@ -15,32 +36,52 @@
  * @param stepper:	Step motor to control.
  * @return:			None.
  */
-void STEPPER_SingleStep(STEPPER_Context* stepper) {
-	// Convert step to state.
-	switch ((stepper -> stepper_current_step) % 4) {
-	// 00.
-	case 0:
-		GPIO_Write((stepper -> stepper_cmd1), 0);
-		GPIO_Write((stepper -> stepper_cmd2), 0);
-		break;
-	// 01.
-	case 1:
-		GPIO_Write((stepper -> stepper_cmd1), 0);
-		GPIO_Write((stepper -> stepper_cmd2), 1);
-		break;
-	// 11.
-	case 2:
-		GPIO_Write((stepper -> stepper_cmd1), 1);
-		GPIO_Write((stepper -> stepper_cmd2), 1);
-		break;
-	// 10.
-	case 3:
-		GPIO_Write((stepper -> stepper_cmd1), 1);
-		GPIO_Write((stepper -> stepper_cmd2), 0);
-		break;
+void TCM_ITCM_FUNCTION STEPPER_SingleStep(STEPPER_Context* stepper) {
+	unsigned char phase = ((stepper -> stepper_current_step) & 0b11);
+	unsigned int bsrr = (stepper -> stepper_phase_bsrr)[phase];
+	STEPPER_Port* port = 0;
+	if ((stepper -> stepper_port_idx) >= STEPPER_PORTS_MAX) {
+		// Pins are on different ports.
+		GPIO_Write((stepper -> stepper_cmd1), ((stepper_phase_table[phase] >> 1) & 0b1));
+		GPIO_Write((stepper -> stepper_cmd2), (stepper_phase_table[phase] & 0b1));
+	}
+	else {
+		port = &(stepper_batch.stepper_ports[stepper -> stepper_port_idx]);
+		if (stepper_batch.stepper_batch_active != 0) {
+			// Replace any pending phase of this motor (words 0 and 2 cover all its set and reset bits).
+			(port -> port_bsrr) &= ~((stepper -> stepper_phase_bsrr)[0] | (stepper -> stepper_phase_bsrr)[2]);
+			(port -> port_bsrr) |= bsrr;
+		}
+		else {
+			(port -> port_address) -> BSRR = bsrr;
+		}
 	}
 }
 
+/* REGISTER THE PORT OF A STEPPER IN BATCH TABLE.
+ * @param port_address:	GPIO port to register.
+ * @return port_idx:	Index of the port in batch table, STEPPER_PORTS_MAX if the table is full.
+ */
+unsigned char STEPPER_RegisterPort(GPIO_BaseAddress* port_address) {
+	unsigned char port_idx = 0;
+	// Search port in table.
+	while ((port_idx < stepper_batch.stepper_ports_count) && ((stepper_batch.stepper_ports[port_idx].port_address) != port_address)) {
+		port_idx++;
+	}
+	// Add new port if possible.
+	if (port_idx == stepper_batch.stepper_ports_count) {
+		if (stepper_batch.stepper_ports_count < STEPPER_PORTS_MAX) {
+			stepper_batch.stepper_ports[port_idx].port_address = port_address;
+			stepper_batch.stepper_ports[port_idx].port_bsrr = 0;
+			stepper_batch.stepper_ports_count++;
+		}
+		else {
+			port_idx = STEPPER_PORTS_MAX;
+		}
+	}
+	return port_idx;
+}
+
 /*** STEPPER functions ***/
 
 /* INIT STEP MOTOR.
@@ -50,6 +91,9 @@ void STEPPER_SingleStep(STEPPER_Context* stepper) {
  * @return:				None.
  */
 void STEPPER_Init(STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO* stepper_cmd2) {
+	unsigned char phase = 0;
+	unsigned int pin1_mask = (0b1 << (stepper_cmd1 -> gpio_num));
+	unsigned int pin2_mask = (0b1 << (stepper_cmd2 -> gpio_num));
 	// Init GPIOs.
 	GPIO_Configure(stepper_cmd1, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
 	GPIO_Configure(stepper_cmd2, GPIO_MODE_OUTPUT, GPIO_TYPE_PUSH_PULL, GPIO_SPEED_LOW, GPIO_PULL_NONE);
@@ -57,13 +101,32 @@ void STEPPER_Init(STEPPER_Context* stepper, const GPIO* stepper_cmd1, const GPIO
 	stepper -> stepper_cmd1 = stepper_cmd1;
 	stepper -> stepper_cmd2 = stepper_cmd2;
 	stepper -> stepper_current_step = 0;
+	// Precompute BSRR word of each phase (upper half resets pins, lower half sets pins).
+	for (phase=0 ; phase<4 ; phase++) {
+		(stepper -> stepper_phase_bsrr)[phase] = (((stepper_phase_table[phase] & 0b10) != 0) ? pin1_mask : (pin1_mask << 16));
+		(stepper -> stepper_phase_bsrr)[phase] |= (((stepper_phase_table[phase] & 0b01) != 0) ? pin2_mask : (pin2_mask << 16));
+	}
+	stepper -> stepper_port_idx = STEPPER_PORTS_MAX;
+	if ((stepper_cmd1 -> gpio_port_address) == (stepper_cmd2 -> gpio_port_address)) {
+		stepper -> stepper_port_idx = STEPPER_RegisterPort(stepper_cmd1 -> gpio_port_address);
+	}
+}
+
+/* SET MOTOR POSITION AND DRIVE THE CORRESPONDING PHASE (TO BE CALLED BEFORE DRIVERS ARE POWERED).
+ * @param stepper:	Step motor to control.
+ * @param step:		Current position of the rotor.
+ * @return:			None.
+ */
+void STEPPER_SetStep(STEPPER_Context* stepper, unsigned int step) {
+	stepper -> stepper_current_step = step;
+	STEPPER_SingleStep(stepper);
 }
 
 /* PERFORM A MOTOR STEP UP.
  * @param:	None.
  * @return:	None.
  */
-void STEPPER_Up(STEPPER_Context* stepper) {
+void TCM_ITCM_FUNCTION STEPPER_Up(STEPPER_Context* stepper) {
 	// Update and perform step.
 	stepper -> stepper_current_step++;
 	STEPPER_SingleStep(stepper);
@@ -73,10 +136,33 @@ void STEPPER_Up(STEPPER_Context* stepper) {
  * @param:	None.
  * @return:	None.
  */
-void STEPPER_Down(STEPPER_Context* stepper) {
+void TCM_ITCM_FUNCTION STEPPER_Down(STEPPER_Context* stepper) {
 	// Update and perform step.
 	if ((stepper -> stepper_current_step) > 0) {
 		stepper -> stepper_current_step--;
 	}
 	STEPPER_SingleStep(stepper);
 }
+
+/* START COMBINING FULL STEP WRITES OF ALL STEPPERS.
+ * @param:	None.
+ * @return:	None.
+ */
+void TCM_ITCM_FUNCTION STEPPER_StartBatch(void) {
+	stepper_batch.stepper_batch_active = 1;
+}
+
+/* APPLY COMBINED FULL STEP WRITES (ONE STORE PER PORT).
+ * @param:	None.
+ * @return:	None.
+ */
+void TCM_ITCM_FUNCTION STEPPER_EndBatch(void) {
+	unsigned char port_idx = 0;
+	for (port_idx=0 ; port_idx<stepper_batch.stepper_ports_count ; port_idx++) {
+		if ((stepper_batch.stepper_ports[port_idx].port_bsrr) != 0) {
+			(stepper_batch.stepper_ports[port_idx].port_address) -> BSRR = stepper_batch.stepper_ports[port_idx].port_bsrr;
+			stepper_batch.stepper_ports[port_idx].port_bsrr = 0;
+		}
+	}
+	stepper_batch.stepper_batch_active = 0;
+}
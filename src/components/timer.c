@@ -0,0 +1,276 @@
+/*
+ * timer.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "timer.h"
+
+#include "nvic.h"
+#include "sched.h"
+#include "tim.h"
+
+/*** TIMER local macros ***/
+
+// Level 0 slots last 1ms, level 1 slots 256ms and level 2 slots 16384ms.
+#define TIMER_LEVEL0_BITS		8
+#define TIMER_LEVEL1_BITS		6
+#define TIMER_LEVEL2_BITS		6
+#define TIMER_LEVEL0_SLOTS		(0b1 << TIMER_LEVEL0_BITS)
+#define TIMER_LEVEL1_SLOTS		(0b1 << TIMER_LEVEL1_BITS)
+#define TIMER_LEVEL2_SLOTS		(0b1 << TIMER_LEVEL2_BITS)
+#define TIMER_LEVEL1_SHIFT		TIMER_LEVEL0_BITS
+#define TIMER_LEVEL2_SHIFT		(TIMER_LEVEL0_BITS + TIMER_LEVEL1_BITS)
+
+/*** TIMER local structures ***/
+
+typedef struct {
+	TIMER_Context* timer_level0[TIMER_LEVEL0_SLOTS];
+	TIMER_Context* timer_level1[TIMER_LEVEL1_SLOTS];
+	TIMER_Context* timer_level2[TIMER_LEVEL2_SLOTS];
+	TIMER_Context* timer_expired; // Timers waiting for their callback to be run by TIMER_Task.
+	unsigned int timer_wheel_ms; // Last processed millisecond.
+	unsigned int timer_running_count;
+} TIMER_WheelContext;
+
+/*** TIMER local global variables ***/
+
+static TIMER_WheelContext timer_wheel_ctx;
+
+/*** TIMER local functions ***/
+
+/* ADD A TIMER AT THE HEAD OF A LIST.
+ * @param timer:	Timer to add.
+ * @param list:		List head.
+ * @return:			None.
+ */
+void TIMER_Link(TIMER_Context* timer, TIMER_Context** list) {
+	timer -> timer_list = list;
+	timer -> timer_previous = 0;
+	timer -> timer_next = (*list);
+	if ((*list) != 0) {
+		(*list) -> timer_previous = timer;
+	}
+	(*list) = timer;
+}
+
+/* REMOVE A TIMER FROM ITS LIST.
+ * @param timer:	Timer to remove.
+ * @return:			None.
+ */
+void TIMER_Unlink(TIMER_Context* timer) {
+	if ((timer -> timer_previous) != 0) {
+		timer -> timer_previous -> timer_next = (timer -> timer_next);
+	}
+	else {
+		(*(timer -> timer_list)) = (timer -> timer_next);
+	}
+	if ((timer -> timer_next) != 0) {
+		timer -> timer_next -> timer_previous = (timer -> timer_previous);
+	}
+	timer -> timer_list = 0;
+	timer -> timer_next = 0;
+	timer -> timer_previous = 0;
+}
+
+/* INSERT A TIMER IN THE WHEEL SLOT MATCHING ITS EXPIRY TIME.
+ * @param timer:	Timer to insert.
+ * @return:			None.
+ */
+void TIMER_Insert(TIMER_Context* timer) {
+	unsigned int delta_ms = (timer -> timer_expiry_ms) - timer_wheel_ctx.timer_wheel_ms;
+	if (delta_ms < TIMER_LEVEL0_SLOTS) {
+		TIMER_Link(timer, &(timer_wheel_ctx.timer_level0[(timer -> timer_expiry_ms) & (TIMER_LEVEL0_SLOTS - 1)]));
+	}
+	else {
+		if (delta_ms < (0b1 << TIMER_LEVEL2_SHIFT)) {
+			TIMER_Link(timer, &(timer_wheel_ctx.timer_level1[((timer -> timer_expiry_ms) >> TIMER_LEVEL1_SHIFT) & (TIMER_LEVEL1_SLOTS - 1)]));
+		}
+		else {
+			TIMER_Link(timer, &(timer_wheel_ctx.timer_level2[((timer -> timer_expiry_ms) >> TIMER_LEVEL2_SHIFT) & (TIMER_LEVEL2_SLOTS - 1)]));
+		}
+	}
+}
+
+/* MOVE ALL TIMERS OF A HIGHER LEVEL SLOT TO LOWER LEVELS.
+ * @param list:	Slot to empty.
+ * @return:		None.
+ */
+void TIMER_Cascade(TIMER_Context** list) {
+	TIMER_Context* timer = 0;
+	while ((*list) != 0) {
+		timer = (*list);
+		TIMER_Unlink(timer);
+		TIMER_Insert(timer);
+	}
+}
+
+/* PROGRAM TIM2 TICK ON NEXT MILLISECOND IF ANY TIMER IS RUNNING.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_Schedule(void) {
+	if (timer_wheel_ctx.timer_running_count != 0) {
+		TIM2_SetTickMs(timer_wheel_ctx.timer_wheel_ms + 1);
+	}
+	else {
+		TIM2_DisableTick();
+	}
+}
+
+/*** TIMER functions ***/
+
+/* INIT TIMER WHEEL.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_Init(void) {
+	unsigned int idx = 0;
+	for (idx=0 ; idx<TIMER_LEVEL0_SLOTS ; idx++) {
+		timer_wheel_ctx.timer_level0[idx] = 0;
+	}
+	for (idx=0 ; idx<TIMER_LEVEL1_SLOTS ; idx++) {
+		timer_wheel_ctx.timer_level1[idx] = 0;
+	}
+	for (idx=0 ; idx<TIMER_LEVEL2_SLOTS ; idx++) {
+		timer_wheel_ctx.timer_level2[idx] = 0;
+	}
+	timer_wheel_ctx.timer_expired = 0;
+	timer_wheel_ctx.timer_wheel_ms = TIM2_GetMs();
+	timer_wheel_ctx.timer_running_count = 0;
+}
+
+/* INIT A TIMER.
+ * @param timer:	Timer to init.
+ * @param callback:	Function called by TIMER_Task when the timer expires.
+ * @return:			None.
+ */
+void TIMER_Register(TIMER_Context* timer, void (*callback)(void)) {
+	timer -> timer_callback = callback;
+	timer -> timer_expiry_ms = 0;
+	timer -> timer_state = TIMER_STATE_STOPPED;
+	timer -> timer_list = 0;
+	timer -> timer_next = 0;
+	timer -> timer_previous = 0;
+}
+
+/* START (OR RESTART) A TIMER.
+ * @param timer:	Timer to start.
+ * @param delay_ms:	Delay before expiry in ms (1 to TIMER_DELAY_MAX_MS).
+ * @return:			None.
+ */
+void TIMER_Start(TIMER_Context* timer, unsigned int delay_ms) {
+	unsigned int local_delay_ms = delay_ms;
+	// Current slot has already been processed.
+	if (local_delay_ms == 0) {
+		local_delay_ms = 1;
+	}
+	if (local_delay_ms > TIMER_DELAY_MAX_MS) {
+		local_delay_ms = TIMER_DELAY_MAX_MS;
+	}
+	NVIC_MaskAllInterrupts();
+	if ((timer -> timer_list) != 0) {
+		TIMER_Unlink(timer);
+		if ((timer -> timer_state) == TIMER_STATE_RUNNING) {
+			timer_wheel_ctx.timer_running_count--;
+		}
+	}
+	if (timer_wheel_ctx.timer_running_count == 0) {
+		// Tick is disabled while the wheel is empty, catch up current time.
+		timer_wheel_ctx.timer_wheel_ms = TIM2_GetMs();
+	}
+	timer -> timer_expiry_ms = timer_wheel_ctx.timer_wheel_ms + local_delay_ms;
+	timer -> timer_state = TIMER_STATE_RUNNING;
+	TIMER_Insert(timer);
+	timer_wheel_ctx.timer_running_count++;
+	if (timer_wheel_ctx.timer_running_count == 1) {
+		TIMER_Schedule();
+	}
+	NVIC_UnmaskAllInterrupts();
+}
+
+/* STOP A TIMER (ITS CALLBACK IS NOT CALLED).
+ * @param timer:	Timer to stop.
+ * @return:			None.
+ */
+void TIMER_Stop(TIMER_Context* timer) {
+	NVIC_MaskAllInterrupts();
+	if ((timer -> timer_list) != 0) {
+		TIMER_Unlink(timer);
+		if ((timer -> timer_state) == TIMER_STATE_RUNNING) {
+			timer_wheel_ctx.timer_running_count--;
+		}
+	}
+	timer -> timer_state = TIMER_STATE_STOPPED;
+	NVIC_UnmaskAllInterrupts();
+}
+
+/* CHECK IF A TIMER IS RUNNING.
+ * @param timer:	Timer to check.
+ * @return:			'1' if the timer is running or if its callback has not been run yet, '0' otherwise.
+ */
+unsigned char TIMER_IsRunning(TIMER_Context* timer) {
+	return ((timer -> timer_state) != TIMER_STATE_STOPPED);
+}
+
+/* ADVANCE THE WHEEL UP TO CURRENT TIME (CALLED BY TIM2 INTERRUPT HANDLER).
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_Process(void) {
+	TIMER_Context* timer = 0;
+	unsigned int now_ms = TIM2_GetMs();
+	unsigned char expired = 0;
+	while (((int) (now_ms - timer_wheel_ctx.timer_wheel_ms)) > 0) {
+		timer_wheel_ctx.timer_wheel_ms++;
+		// Cascade higher levels when lower level wraps.
+		if ((timer_wheel_ctx.timer_wheel_ms & (TIMER_LEVEL0_SLOTS - 1)) == 0) {
+			if (((timer_wheel_ctx.timer_wheel_ms >> TIMER_LEVEL1_SHIFT) & (TIMER_LEVEL1_SLOTS - 1)) == 0) {
+				TIMER_Cascade(&(timer_wheel_ctx.timer_level2[(timer_wheel_ctx.timer_wheel_ms >> TIMER_LEVEL2_SHIFT) & (TIMER_LEVEL2_SLOTS - 1)]));
+			}
+			TIMER_Cascade(&(timer_wheel_ctx.timer_level1[(timer_wheel_ctx.timer_wheel_ms >> TIMER_LEVEL1_SHIFT) & (TIMER_LEVEL1_SLOTS - 1)]));
+		}
+		// Move expired timers to the callback list.
+		while (timer_wheel_ctx.timer_level0[timer_wheel_ctx.timer_wheel_ms & (TIMER_LEVEL0_SLOTS - 1)] != 0) {
+			timer = timer_wheel_ctx.timer_level0[timer_wheel_ctx.timer_wheel_ms & (TIMER_LEVEL0_SLOTS - 1)];
+			TIMER_Unlink(timer);
+			timer -> timer_state = TIMER_STATE_EXPIRED;
+			TIMER_Link(timer, &(timer_wheel_ctx.timer_expired));
+			timer_wheel_ctx.timer_running_count--;
+			expired = 1;
+		}
+		// Time may have elapsed while processing.
+		now_ms = TIM2_GetMs();
+	}
+	if (expired != 0) {
+		SCHED_PostEvent(SCHED_EVENT_TIMER);
+	}
+	TIMER_Schedule();
+	// Tick may have been missed while compare register was written.
+	if (((int) (TIM2_GetMs() - timer_wheel_ctx.timer_wheel_ms)) > 0) {
+		TIM2_ForceTickEvent();
+	}
+}
+
+/* RUN THE CALLBACKS OF EXPIRED TIMERS (SCHEDULED ON SCHED_EVENT_TIMER).
+ * @param:	None.
+ * @return:	None.
+ */
+void TIMER_Task(void) {
+	TIMER_Context* timer = 0;
+	NVIC_MaskAllInterrupts();
+	timer = timer_wheel_ctx.timer_expired;
+	while (timer != 0) {
+		TIMER_Unlink(timer);
+		timer -> timer_state = TIMER_STATE_STOPPED;
+		NVIC_UnmaskAllInterrupts();
+		// Callback may restart the timer.
+		if ((timer -> timer_callback) != 0) {
+			(timer -> timer_callback)();
+		}
+		NVIC_MaskAllInterrupts();
+		timer = timer_wheel_ctx.timer_expired;
+	}
+	NVIC_UnmaskAllInterrupts();
+}
@@ -7,11 +7,25 @@
 
 // Peripherals.
 #include "adc.h"
+#include "cache.h"
 #include "dac.h"
+#include "dma.h"
+#include "dwt.h"
 #include "gpio.h"
 #include "rcc.h"
+#include "tcm.h"
 #include "tim.h"
 #include "usart.h"
+// Components.
+#include "blink.h"
+#include "hist.h"
+#include "load.h"
+#include "pcs.h"
+#include "prof.h"
+#include "pwrm.h"
+#include "sched.h"
+#include "sig.h"
+#include "timer.h"
 // Applicative.
 #include "bl.h"
 #include "common.h"
@@ -27,6 +41,7 @@
 #include "mp.h"
 #include "mpinv.h"
 #include "pbl2.h"
+#include "pneu.h"
 #include "s.h"
 #include "tch.h"
 #include "vacma.h"
@@ -34,26 +49,54 @@
 #include "zlfr.h"
 #include "zpt.h"
 
+/*** MAIN local macros ***/
+
+// Scheduler priorities (lowest value first).
+#define MAIN_PRIORITY_COMMUNICATION		0
+#define MAIN_PRIORITY_ACTUATORS			1
+#define MAIN_PRIORITY_MODELS			2
+#define MAIN_PRIORITY_DASHBOARD			3
+// Scheduler periods.
+#define MAIN_PERIOD_EVENT_ONLY			0
+#define MAIN_PERIOD_MANOS_MS			1	// Needle models integration period.
+#define MAIN_PERIOD_DASHBOARD_MS		10	// Much lower than switches debouncing delays.
+#define MAIN_PERIOD_LOAD_MS				100	// CPU load is sampled every second.
+#define MAIN_PERIOD_DUMP_MS				50	// Diagnostics dumps send at most 45 characters per call (47ms at 9600 bauds).
+
 /*** Main global variables ***/
 
+// Shared context is accessed by interrupt handlers (needles and steppers).
+LSMCU_Context lsmcu_ctx TCM_DTCM_DATA;
+
 /* MAIN FUNCTION.
  * @param: 	None.
  * @return: 0.
  */
 int main(void) {
+	unsigned int loop_start_cycles = 0;
+	unsigned int loop_end_cycles = 0;
 	// Init Peripherals.
 	RCC_Init();
+	CACHE_Init();
+	DWT_Init(); // Cycle counter.
 	GPIO_Init();
 	TIM2_Init(); // Time keeper.
 	TIM5_Init(); // Tachro.
 	TIM6_Init(); // KVB sweep.
 	TIM7_Init(); // Manometers.
 	TIM8_Init(); // LVAL PWM.
+	DMA2_InitStream1(); // LVAL waveform.
 	ADC1_Init();
 	DAC_Init();
 	USART1_Init();
 	// Init communication interface.
 	LSSGKCU_Init();
+	// Init blink engine.
+	BLINK_Init();
+	// Init signal bus (before modules subscribe).
+	SIG_Init(MAIN_PERIOD_DASHBOARD_MS);
+	// Init timer wheel.
+	TIMER_Init();
 	// Init dashboard modules.
 	BL_Init();
 	COMP_Init();
@@ -63,43 +106,74 @@ int main(void) {
 	IL_Init();
 	KVB_Init();
 	MANOS_Init();
-	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cp), &(lsmcu_ctx.lsmcu_stepper_cp), &GPIO_MCP_1, &GPIO_MCP_2, 100, 3072, 20, 100);
-	MANO_Init(&(lsmcu_ctx.lsmcu_mano_re), &(lsmcu_ctx.lsmcu_stepper_re), &GPIO_MRE_1, &GPIO_MRE_2, 100, 3072, 20, 100);
-	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cg), &(lsmcu_ctx.lsmcu_stepper_cg), &GPIO_MCG_1, &GPIO_MCG_2, 100, 3072, 20, 100);
-	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cf1), &(lsmcu_ctx.lsmcu_stepper_cf1), &GPIO_MCF1_1, &GPIO_MCF1_2, 60, 3072, 20, 100);
-	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cf2), &(lsmcu_ctx.lsmcu_stepper_cf2), &GPIO_MCF2_1, &GPIO_MCF2_2, 60, 3072, 20, 100);
+	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cp), &(lsmcu_ctx.lsmcu_stepper_cp), &GPIO_MCP_1, &GPIO_MCP_2, 100, 3072, 100);
+	MANO_Init(&(lsmcu_ctx.lsmcu_mano_re), &(lsmcu_ctx.lsmcu_stepper_re), &GPIO_MRE_1, &GPIO_MRE_2, 100, 3072, 100);
+	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cg), &(lsmcu_ctx.lsmcu_stepper_cg), &GPIO_MCG_1, &GPIO_MCG_2, 100, 3072, 100);
+	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cf1), &(lsmcu_ctx.lsmcu_stepper_cf1), &GPIO_MCF1_1, &GPIO_MCF1_2, 60, 3072, 100);
+	MANO_Init(&(lsmcu_ctx.lsmcu_mano_cf2), &(lsmcu_ctx.lsmcu_stepper_cf2), &GPIO_MCF2_1, &GPIO_MCF2_2, 60, 3072, 100);
 	MP_Init();
 	MPINV_Init();
 	PBL2_Init();
+	PNEU_Init();
 	S_Init();
 	TCH_Init();
 	VACMA_Init();
 	ZBA_Init();
 	ZLFR_Init();
 	ZPT_Init();
+	// Init power manager.
+	PWRM_Init();
+	// Init diagnostics.
+	HIST_Init();
+	LOAD_Init();
+#ifdef PROF_ENABLED
+	PROF_Init();
+#endif
+#ifdef PCS_ENABLED
+	PCS_Init();
+#endif
+	// Init scheduler.
+	SCHED_Init();
+	SCHED_Register(&ADC1_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_ADC1_EOC, MAIN_PRIORITY_COMMUNICATION);
+	SCHED_Register(&LSSGKCU_Task, MAIN_PERIOD_EVENT_ONLY, SCHED_EVENT_USART1_RX, MAIN_PRIORITY_COMMUNICATION);
+	SCHED_Register(&TIMER_Task, MAIN_PERIOD_EVENT_ONLY, SCHED_EVENT_TIMER, MAIN_PRIORITY_ACTUATORS);
+	SCHED_Register(&MANOS_Task, MAIN_PERIOD_MANOS_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_ACTUATORS);
+	SCHED_Register(&TCH_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_ACTUATORS);
+	SCHED_Register(&MANOS_ManagePower, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_ACTUATORS);
+	SCHED_Register(&PNEU_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_MODELS);
+	SCHED_Register(&BL_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&COMP_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&DEP_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&FD_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&FPB_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&KVB_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&MP_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&MPINV_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&PBL2_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&S_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&VACMA_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&ZBA_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&PWRM_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&ZPT_Task, MAIN_PERIOD_DASHBOARD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&SIG_Task, MAIN_PERIOD_EVENT_ONLY, SCHED_EVENT_SIGNAL, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&LOAD_Task, MAIN_PERIOD_LOAD_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+	SCHED_Register(&HIST_Task, MAIN_PERIOD_DUMP_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+#ifdef PROF_ENABLED
+	SCHED_Register(&PROF_Task, MAIN_PERIOD_DUMP_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+#endif
+#ifdef PCS_ENABLED
+	SCHED_Register(&PCS_Task, MAIN_PERIOD_DUMP_MS, SCHED_EVENT_NONE, MAIN_PRIORITY_DASHBOARD);
+#endif
 	// Main loop.
+	loop_start_cycles = DWT_GetCycleCount();
 	while (1) {
-		// Peripherals tasks.
-		ADC1_Task();
-		// Communication tasks.
-		LSSGKCU_Task();
-		// Dashboard tasks.
-		BL_Task();
-		COMP_Task();
-		DEP_Task();
-		FD_Task();
-		FPB_Task();
-		IL_Task();
-		KVB_Task();
-		MANOS_ManagePower();
-		MP_Task();
-		MPINV_Task();
-		PBL2_Task();
-		S_Task();
-		TCH_Task();
-		VACMA_Task();
-		ZBA_Task();
-		ZPT_Task();
+		// Measure main loop period.
+		loop_end_cycles = DWT_GetCycleCount();
+		HIST_Add(HIST_ID_MAIN_LOOP_PERIOD, loop_end_cycles - loop_start_cycles);
+		loop_start_cycles = loop_end_cycles;
+		SCHED_Run();
+		// Sleep until next event or task deadline.
+		SCHED_Sleep();
 	}
 	return (0);
 }
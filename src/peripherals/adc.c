@@ -15,8 +15,11 @@
 #include "mapping.h"
 #include "mpinv.h"
 #include "pbl2.h"
+#include "prof.h"
+#include "nvic.h"
 #include "rcc_reg.h"
 #include "s.h"
+#include "sched.h"
 #include "zpt.h"
 
 /*** ADC local macros ***/
@@ -55,6 +58,21 @@ static ADC_State adc_state;
 
 /*** ADC local functions ***/
 
+/* ADC INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void ADC_InterruptHandler(void) {
+	PROF_START(PROF_ID_ADC_IRQ);
+	// End of conversion.
+	if (((ADC1 -> SR) & (0b1 << 1)) != 0) {
+		// Disable interrupt (EOC flag is cleared when result is read by ADC task).
+		ADC1 -> CR1 &= ~(0b1 << 5); // EOCIE='0'.
+		SCHED_PostEvent(SCHED_EVENT_ADC1_EOC);
+	}
+	PROF_STOP(PROF_ID_ADC_IRQ);
+}
+
 /* SET THE CURRENT CHANNEL OF ADC1.
  * @param channel: 		ADC channel (x for 'ADCChannelx', 17 for 'VREF' or 18 for 'VBAT').
  * @return: 			None.
@@ -77,6 +95,8 @@ void ADC1_SetChannel(unsigned char channel) {
 void ADC1_StartConversion(void) {
 	// Clear EOC flag.
 	ADC1 -> SR &= ~(0b1 << 1);
+	// Wake-up ADC task at the end of conversion.
+	ADC1 -> CR1 |= (0b1 << 5); // EOCIE='1'.
 	// Start conversion.
 	ADC1 -> CR2 |= (0b1 << 30); // SWSTART='1'.
 }
@@ -120,6 +140,17 @@ void ADC1_Init(void) {
 	ADC1 -> CR2 &= ~(0b1 << 11); // // Result in right alignement (ALIGN='0').
 	// Enable ADC.
 	ADC1 -> CR2 |= (0b1 << 0); // ADON='1'.
+	// Enable interrupt.
+	NVIC_SetPriority(IT_ADC, NVIC_PRIORITY_PERIPHERAL);
+	NVIC_EnableInterrupt(IT_ADC);
+}
+
+/* GET ADC CONVERSIONS SEQUENCE STATE.
+ * @param:	None.
+ * @return:	'1' if a conversions sequence is in progress, '0' otherwise.
+ */
+unsigned char ADC1_IsRunning(void) {
+	return ((adc_state != ADC_STATE_OFF) ? 1 : 0);
 }
 
 /* MAIN ROUTINE OF ADC.
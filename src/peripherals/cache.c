@@ -0,0 +1,80 @@
+/*
+ * cache.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "cache.h"
+
+#include "scb_reg.h"
+
+/*** CACHE local functions ***/
+
+/* INVALIDATE THE WHOLE L1 DATA CACHE (CONTENT IS UNDEFINED AFTER RESET).
+ * @param:	None.
+ * @return:	None.
+ */
+void CACHE_InvalidateAllData(void) {
+	unsigned int ccsidr = 0;
+	unsigned int sets_number = 0;
+	unsigned int ways_number = 0;
+	unsigned int line_shift = 0;
+	unsigned int way_shift = 0;
+	unsigned int set = 0;
+	unsigned int way = 0;
+	// Read L1 data cache geometry.
+	SCB -> CSSELR = 0; // Level 1 data cache (InD='0').
+	__asm volatile ("dsb" : : : "memory");
+	ccsidr = (SCB -> CCSIDR);
+	sets_number = ((ccsidr >> 13) & 0x7FFF) + 1;
+	ways_number = ((ccsidr >> 3) & 0x3FF) + 1;
+	line_shift = (ccsidr & 0b111) + 4;
+	way_shift = (ways_number > 1) ? __builtin_clz(ways_number - 1) : 0;
+	// Invalidate each line by set and way.
+	for (set=0 ; set<sets_number ; set++) {
+		for (way=0 ; way<ways_number ; way++) {
+			SCB -> DCISW = (set << line_shift) | (way << way_shift);
+		}
+	}
+	__asm volatile ("dsb" : : : "memory");
+}
+
+/*** CACHE functions ***/
+
+/* INVALIDATE AND ENABLE CORTEX-M7 L1 INSTRUCTION AND DATA CACHES.
+ * @param:	None.
+ * @return:	None.
+ */
+void CACHE_Init(void) {
+	// Instruction cache.
+	__asm volatile ("dsb" : : : "memory");
+	__asm volatile ("isb" : : : "memory");
+	SCB -> ICIALLU = 0;
+	__asm volatile ("dsb" : : : "memory");
+	__asm volatile ("isb" : : : "memory");
+	SCB -> CCR |= (0b1 << 17); // IC='1'.
+	__asm volatile ("dsb" : : : "memory");
+	__asm volatile ("isb" : : : "memory");
+	// Data cache (write-back on SRAM, buffers read by DMA must be cleaned with CACHE_CleanData).
+	CACHE_InvalidateAllData();
+	SCB -> CCR |= (0b1 << 16); // DC='1'.
+	__asm volatile ("dsb" : : : "memory");
+	__asm volatile ("isb" : : : "memory");
+}
+
+/* WRITE BACK DATA CACHE LINES OF A BUFFER TO MEMORY (BEFORE A DMA READS IT).
+ * @param address:		Buffer address.
+ * @param size_bytes:	Buffer size in bytes.
+ * @return:				None.
+ */
+void CACHE_CleanData(void* address, unsigned int size_bytes) {
+	unsigned int line_address = ((unsigned int) address) & ~(CACHE_LINE_SIZE_BYTES - 1);
+	unsigned int end_address = ((unsigned int) address) + size_bytes;
+	__asm volatile ("dsb" : : : "memory");
+	while (line_address < end_address) {
+		SCB -> DCCMVAC = line_address;
+		line_address += CACHE_LINE_SIZE_BYTES;
+	}
+	__asm volatile ("dsb" : : : "memory");
+}
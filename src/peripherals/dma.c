@@ -0,0 +1,72 @@
+/*
+ * dma.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "dma.h"
+
+#include "cache.h"
+#include "dma_reg.h"
+#include "rcc_reg.h"
+#include "tim_reg.h"
+
+/*** DMA local macros ***/
+
+// DMA2 stream 1 is linked to TIM8 update event on channel 7.
+#define DMA2_STREAM1_TIM8_UP_CHANNEL	7
+
+/*** DMA functions ***/
+
+/* CONFIGURE DMA2 STREAM 1 TO TRANSFER A CIRCULAR BUFFER TO TIM8 CCR1 ON EACH TIM8 UPDATE EVENT.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA2_InitStream1(void) {
+	// Enable peripheral clock.
+	RCC -> AHB1ENR |= (0b1 << 22); // DMA2EN='1'.
+	// Disable stream and wait for it to be effectively disabled.
+	DMA2 -> STREAM[1].CR &= ~(0b1 << 0); // EN='0'.
+	while (((DMA2 -> STREAM[1].CR) & (0b1 << 0)) != 0);
+	// Configure stream.
+	DMA2 -> STREAM[1].CR = 0; // Reset all bits (peripheral flow controller disabled, no double buffer, no burst).
+	DMA2 -> STREAM[1].CR |= (DMA2_STREAM1_TIM8_UP_CHANNEL << 25); // CHSEL='111'.
+	DMA2 -> STREAM[1].CR |= (0b10 << 16); // High priority (PL='10').
+	DMA2 -> STREAM[1].CR |= (0b10 << 13); // Memory data size = 32 bits (MSIZE='10').
+	DMA2 -> STREAM[1].CR |= (0b10 << 11); // Peripheral data size = 32 bits (PSIZE='10').
+	DMA2 -> STREAM[1].CR |= (0b1 << 10); // Memory address incremented (MINC='1').
+	DMA2 -> STREAM[1].CR |= (0b1 << 8); // Circular mode (CIRC='1').
+	DMA2 -> STREAM[1].CR |= (0b01 << 6); // Memory to peripheral (DIR='01').
+	DMA2 -> STREAM[1].FCR &= ~(0b1 << 2); // Direct mode (DMDIS='0').
+	// Peripheral address.
+	DMA2 -> STREAM[1].PAR = (unsigned int) &(TIM8 -> CCR1);
+}
+
+/* START DMA2 STREAM 1.
+ * @param source_buf:		Buffer to transfer circularly to TIM8 CCR1.
+ * @param source_buf_size:	Number of words in buffer.
+ * @return:					None.
+ */
+void DMA2_StartStream1(unsigned int* source_buf, unsigned short source_buf_size) {
+	// Stream registers can only be written when stream is disabled.
+	DMA2_StopStream1();
+	// DMA reads memory directly, write back buffer from data cache.
+	CACHE_CleanData(source_buf, source_buf_size * sizeof(unsigned int));
+	DMA2 -> STREAM[1].M0AR = (unsigned int) source_buf;
+	DMA2 -> STREAM[1].NDTR = source_buf_size;
+	// Clear all stream 1 flags.
+	DMA2 -> LIFCR = (0b111101 << 6); // CTCIF1='1', CHTIF1='1', CTEIF1='1', CDMEIF1='1' and CFEIF1='1'.
+	// Enable stream.
+	DMA2 -> STREAM[1].CR |= (0b1 << 0); // EN='1'.
+}
+
+/* STOP DMA2 STREAM 1.
+ * @param:	None.
+ * @return:	None.
+ */
+void DMA2_StopStream1(void) {
+	// Disable stream and wait for current transfer to complete.
+	DMA2 -> STREAM[1].CR &= ~(0b1 << 0); // EN='0'.
+	while (((DMA2 -> STREAM[1].CR) & (0b1 << 0)) != 0);
+}
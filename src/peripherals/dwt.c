@@ -0,0 +1,38 @@
+/*
+ * dwt.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "dwt.h"
+
+#include "dwt_reg.h"
+
+/*** DWT local macros ***/
+
+#define DWT_LAR_UNLOCK_KEY	0xC5ACCE55
+
+/*** DWT functions ***/
+
+/* ENABLE DWT CYCLE COUNTER.
+ * @param:	None.
+ * @return:	None.
+ */
+void DWT_Init(void) {
+	// Enable trace and debug blocks.
+	(*DEMCR) |= (0b1 << 24); // TRCENA='1'.
+	// Unlock DWT registers (required on Cortex-M7 when no debugger is attached).
+	DWT -> LAR = DWT_LAR_UNLOCK_KEY;
+	// Reset and start cycle counter.
+	DWT -> CYCCNT = 0;
+	DWT -> CTRL |= (0b1 << 0); // CYCCNTENA='1'.
+}
+
+/* READ DWT CYCLE COUNTER.
+ * @param:			None.
+ * @return cycles:	Number of core clock cycles since DWT_Init (wraps every 2^32 cycles).
+ */
+unsigned int DWT_GetCycleCount(void) {
+	return (DWT -> CYCCNT);
+}
@@ -10,6 +10,7 @@
 #include "gpio_reg.h"
 #include "mapping.h"
 #include "rcc_reg.h"
+#include "tcm.h"
 
 /*** GPIO local macros ***/
 
@@ -239,14 +240,15 @@ void GPIO_Init(void) {
  * @param state: 	Desired state of the pin ('0' or '1').
  * @return: 		None.
  */
-void GPIO_Write(const GPIO* gpio, unsigned char state) {
+void TCM_ITCM_FUNCTION GPIO_Write(const GPIO* gpio, unsigned char state) {
 	// Ensure GPIO exists.
 	if (((gpio -> gpio_num) >= 0) && ((gpio -> gpio_num) < GPIO_PER_PORT)) {
+		// Use BSRR to be atomic (GPIOs may also be written under interrupt).
 		if (state == 0) {
-			(gpio -> gpio_port_address) -> ODR &= ~(0b1 << (gpio -> gpio_num));
+			(gpio -> gpio_port_address) -> BSRR = (0b1 << ((gpio -> gpio_num) + 16)); // BRx='1'.
 		}
 		else {
-			(gpio -> gpio_port_address) -> ODR |= (0b1 << (gpio -> gpio_num));
+			(gpio -> gpio_port_address) -> BSRR = (0b1 << (gpio -> gpio_num)); // BSx='1'.
 		}
 	}
 }
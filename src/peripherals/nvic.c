@@ -39,6 +39,22 @@ void NVIC_SetPriority(InterruptVector it_num, unsigned char priority) {
 	NVIC -> IPR[it_num] = priority;
 }
 
+/* MASK ALL INTERRUPTS (PENDING INTERRUPTS STILL WAKE-UP THE CORE FROM SLEEP MODE).
+ * @param:	None.
+ * @return:	None.
+ */
+void NVIC_MaskAllInterrupts(void) {
+	__asm volatile ("cpsid i" : : : "memory"); // PRIMASK='1'.
+}
+
+/* UNMASK ALL INTERRUPTS.
+ * @param:	None.
+ * @return:	None.
+ */
+void NVIC_UnmaskAllInterrupts(void) {
+	__asm volatile ("cpsie i" : : : "memory"); // PRIMASK='0'.
+}
+
 /* @NOTE:
  * To add an interrupt from a given peripheral:
  * 		1) Configure and enable interrupts in the proper(s) peripheral register(s).
@@ -0,0 +1,64 @@
+/*
+ * pwr.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "pwr.h"
+
+#include "pwr_reg.h"
+#include "rcc_reg.h"
+#include "scb_reg.h"
+
+/*** PWR functions ***/
+
+/* ENABLE ACCESS TO BACKUP SRAM (CONTENT IS KEPT ACROSS RESETS, AND ACROSS POWER CYCLES IF VBAT IS SUPPLIED).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWR_EnableBackupSram(void) {
+	// Enable peripheral clocks.
+	RCC -> APB1ENR |= (0b1 << 28); // PWREN='1'.
+	RCC -> AHB1ENR |= (0b1 << 18); // BKPSRAMEN='1'.
+	// Disable backup domain write protection.
+	PWR -> CR1 |= (0b1 << 8); // DBP='1'.
+	// Enable backup regulator and wait for it to be ready.
+	PWR -> CSR1 |= (0b1 << 9); // BRE='1'.
+	while (((PWR -> CSR1) & (0b1 << 3)) == 0); // Wait for BRR='1'.
+}
+
+/* READ A WORD IN BACKUP SRAM.
+ * @param word_idx:	Word index (0 to PWR_BACKUP_SRAM_SIZE_WORDS-1).
+ * @return:			Word value (0 if index is out of range).
+ */
+unsigned int PWR_ReadBackupSram(unsigned int word_idx) {
+	unsigned int value = 0;
+	if (word_idx < PWR_BACKUP_SRAM_SIZE_WORDS) {
+		value = BKPSRAM[word_idx];
+	}
+	return value;
+}
+
+/* WRITE A WORD IN BACKUP SRAM.
+ * @param word_idx:	Word index (0 to PWR_BACKUP_SRAM_SIZE_WORDS-1).
+ * @param value:	Value to write.
+ * @return:			None.
+ */
+void PWR_WriteBackupSram(unsigned int word_idx, unsigned int value) {
+	if (word_idx < PWR_BACKUP_SRAM_SIZE_WORDS) {
+		BKPSRAM[word_idx] = value;
+	}
+}
+
+/* ENTER SLEEP MODE (CORE CLOCK STOPPED, PERIPHERALS RUNNING).
+ * @param:	None.
+ * @return:	None.
+ */
+void PWR_EnterSleepMode(void) {
+	// Select sleep mode instead of stop mode.
+	SCB -> SCR &= ~(0b1 << 2); // SLEEPDEEP='0'.
+	// Wait for interrupt (the core wakes-up on any pending interrupt, even if masked).
+	__asm volatile ("dsb" : : : "memory");
+	__asm volatile ("wfi");
+}
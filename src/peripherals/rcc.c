@@ -8,8 +8,58 @@
 #include "rcc.h"
 
 #include "flash_reg.h"
+#include "pwr_reg.h"
 #include "rcc_reg.h"
 
+/*** RCC local macros ***/
+
+// Source = HSI 16MHz, M = 16 -> PLL input clock = 1MHz (typical value), P = 2 -> PLLCLK = VCO/2.
+// VCO output clock = N MHz (min 100 - max 432), PLL48CLK = VCO/Q.
+// Flash latency for VDD in 2.7-3.6V range: 1 wait state (WS) per 30MHz of HCLK (see p.74 of RM0385 datasheet).
+#ifdef RCC_PROFILE_LOW_POWER
+// HCLK = SYSCLK = 50MHz, PCLK1 = HCLK/2 = 25MHz, PCLK2 = HCLK/2 = 25MHz.
+#define RCC_PLLN				100
+#define RCC_PLLQ				2 // PLL48CLK = 50MHz.
+#define RCC_PPRE1				0b100 // 2.
+#define RCC_PPRE2				0b100 // 2.
+#define RCC_FLASH_LATENCY		1
+#define RCC_VOS					0b01 // Scale 3 (HCLK max 144MHz).
+#endif
+#ifdef RCC_PROFILE_NOMINAL
+// HCLK = SYSCLK = 100MHz, PCLK1 = HCLK/4 = 25MHz, PCLK2 = HCLK/4 = 25MHz.
+#define RCC_PLLN				200
+#define RCC_PLLQ				4 // PLL48CLK = 50MHz.
+#define RCC_PPRE1				0b101 // 4.
+#define RCC_PPRE2				0b101 // 4.
+#define RCC_FLASH_LATENCY		3
+#define RCC_VOS					0b01 // Scale 3 (HCLK max 144MHz).
+#endif
+#ifdef RCC_PROFILE_MAX_PERFORMANCE
+// HCLK = SYSCLK = 216MHz, PCLK1 = HCLK/8 = 27MHz (max 54), PCLK2 = HCLK/4 = 54MHz (max 108).
+#define RCC_PLLN				432
+#define RCC_PLLQ				9 // PLL48CLK = 48MHz.
+#define RCC_PPRE1				0b110 // 8.
+#define RCC_PPRE2				0b101 // 4.
+#define RCC_FLASH_LATENCY		7
+#define RCC_VOS					0b11 // Scale 1 (HCLK max 216MHz with over-drive).
+#define RCC_OVERDRIVE
+#endif
+// Peripherals only used while the cab is powered.
+#define RCC_APB1ENR_DASHBOARD_MASK	((0b1 << 3) | (0b1 << 4) | (0b1 << 5) | (0b1 << 29)) // TIM5EN, TIM6EN, TIM7EN and DACEN.
+#define RCC_APB2ENR_DASHBOARD_MASK	((0b1 << 1) | (0b1 << 8)) // TIM8EN and ADC1EN.
+
+/*** RCC local structures ***/
+
+typedef struct {
+	unsigned int rcc_sysclk_khz;
+	unsigned int rcc_pclk1_khz;
+	unsigned int rcc_pclk2_khz;
+} RCC_Context;
+
+/*** RCC local global variables ***/
+
+static RCC_Context rcc_ctx;
+
 /*** RCC functions ***/
 
 /* CONFIGURE MCU CLOCK TREE.
@@ -23,38 +73,145 @@ void RCC_Init(void) {
 	while (((RCC -> CR) & (0b1 << 1)) == 0); // // Wait for HSI to be stable (HSIRDY='1').
 	RCC -> CFGR &= ~(0b11 << 0); // Select HSI as system clock (SW='00').
 	while (((RCC -> CFGR) & (0b11 << 0)) != 0b00); // // Wait for clock switch (SWS='00').
-	// Peripherals clock prescalers:
-	// HPRE = 1 -> HCLK = SYSCLK = 100MHz (max 216).
-	// PPRE1 = 4 -> PCLK1 = HCLK/4 = 25MHz (max 54).
-	// PPRE2 = 4 -> PCLK2 = HCLK/4 = 25MHz (max 108).
-	RCC -> CFGR &= 0xFFE0030F; // Reset bits 4-7 and 10-15 + HPRE='0000' (1).
-	RCC -> CFGR |= (0b101 << 10) | (0b101 << 13); // PPRE1='101' (4) and PPRE2='101' (4).
-	RCC -> DKCFGR1 &= ~(0b1 << 24); // Timers clock is 2*PLCKx (PPRE1 and PPRE2 != 1).
+	// Enable flash prefetch and ART accelerator (reset while disabled).
+	FLASH -> ACR &= ~(0b1 << 9); // ARTEN='0'.
+	FLASH -> ACR |= (0b1 << 11); // ARTRST='1'.
+	FLASH -> ACR &= ~(0b1 << 11); // ARTRST='0'.
+	FLASH -> ACR |= (0b1 << 8) | (0b1 << 9); // PRFTEN='1' and ARTEN='1'.
+	// Switch to profile clock.
+	RCC_EnableRunPll();
+	RCC_SwitchToRunClock();
+#ifdef RCC_OUTPUT_CLOCK
+	// Output HSI on MCO1 (PA8 as AF0) and SYSCLK on MCO2 (PC9 as AF0) with both prescalers = 4.
+	RCC -> CFGR &= 0x369FFFFF;
+	RCC -> CFGR |= 0x36000000;
+#endif
+}
+
+/* START MAIN PLL WITH PROFILE SETTINGS WHILE HSI IS STILL USED AS SYSTEM CLOCK.
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_EnableRunPll(void) {
 	// Configure main PLL.
 	RCC -> CR &= ~(0b1 << 24);
-	// Source = HSI 16MHz
-	// M = 16 -> input clock = 1MHz (typical value).
-	// N = 200 -> VCO output clock = 200MHz (max 432).
-	// P = 2 -> PLLCLK = 100MHz (max 216).
-	// Q = 4 -> PLL48CLK = 50MHz (min 48 - max 75).
+	// Regulator voltage scale can only be modified while PLL is off.
+	RCC -> APB1ENR |= (0b1 << 28); // PWREN='1'.
+	PWR -> CR1 &= ~(0b11 << 14);
+	PWR -> CR1 |= (RCC_VOS << 14);
 	RCC -> PLLCFGR = 0; // Reset all bits + PLLSRC='0' (HSI) + PLLP='00' (2)
-	RCC -> PLLCFGR |= (16 << 0) | (200 << 6) | (4 << 24);
+	RCC -> PLLCFGR |= (16 << 0) | (RCC_PLLN << 6) | (RCC_PLLQ << 24);
 	// Enable PLL.
 	RCC -> CR |= (0b1 << 24);
 	// Wait for PLL to be ready.
 	while (((RCC -> CR) & (0b1 << 25)) == 0);
-	// Use main PLL output clock as system clock.
-	FLASH -> ACR |= (0b1 << 8); // Enable flash prefetch.
-	// Increase flash latency according to new system clock frequency (see p.74 of RM0385 datasheet).
-	// HCLK = SYSCLK = 100MHz -> flash latency must be set to 3 wait states (WS).
+	// Wait for regulator voltage scale to be applied (VOSRDY='1').
+	while (((PWR -> CSR1) & (0b1 << 14)) == 0);
+#ifdef RCC_OVERDRIVE
+	// Enable over-drive mode (required above 180MHz) and switch regulator to it.
+	PWR -> CR1 |= (0b1 << 16); // ODEN='1'.
+	while (((PWR -> CSR1) & (0b1 << 16)) == 0); // Wait for ODRDY='1'.
+	PWR -> CR1 |= (0b1 << 17); // ODSWEN='1'.
+	while (((PWR -> CSR1) & (0b1 << 17)) == 0); // Wait for ODSWRDY='1'.
+#endif
+	// Increase flash latency according to new system clock frequency.
 	FLASH -> ACR &= ~(0b1111 << 0); // Reset bits 0-3.
-	FLASH -> ACR |= 3; // LATENCY=3.
-	while (((FLASH -> ACR) & (0b1111 << 0)) != 3);
+	FLASH -> ACR |= RCC_FLASH_LATENCY;
+	while (((FLASH -> ACR) & (0b1111 << 0)) != RCC_FLASH_LATENCY);
+}
+
+/* SWITCH SYSTEM CLOCK FROM HSI TO MAIN PLL (PLL MUST HAVE BEEN STARTED WITH RCC_EnableRunPll).
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_SwitchToRunClock(void) {
+	// Peripherals clock prescalers (HPRE = 1 -> HCLK = SYSCLK), applied just before the switch so that APB clocks
+	// only run at an intermediate frequency for a few cycles.
+	RCC -> CFGR &= 0xFFE0030F; // Reset bits 4-7 and 10-15 + HPRE='0000' (1).
+	RCC -> CFGR |= (RCC_PPRE1 << 10) | (RCC_PPRE2 << 13);
+	RCC -> DKCFGR1 &= ~(0b1 << 24); // Timers clock is 2*PLCKx (PPRE1 and PPRE2 != 1).
+	// Use main PLL output clock as system clock.
 	RCC -> CFGR |= (0b10 << 0); // // Select PLLCLK (SW='10').
 	while (((RCC -> CFGR) & (0b11 << 0)) != 0b10); // // Wait for clock switch (SWS='00').
-#ifdef RCC_OUTPUT_CLOCK
-	// Output HSI on MCO1 (PA8 as AF0) and SYSCLK on MCO2 (PC9 as AF0) with both prescalers = 4.
-	RCC -> CFGR &= 0x369FFFFF;
-	RCC -> CFGR |= 0x36000000;
+	// Update clocks frequency.
+	rcc_ctx.rcc_sysclk_khz = RCC_SYSCLK_KHZ;
+	rcc_ctx.rcc_pclk1_khz = RCC_PCLK1_KHZ;
+	rcc_ctx.rcc_pclk2_khz = RCC_PCLK2_KHZ;
+}
+
+/* SWITCH SYSTEM CLOCK FROM MAIN PLL TO HSI (PLL IS KEPT RUNNING UNTIL RCC_DisableRunPll IS CALLED).
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_SwitchToStandbyClock(void) {
+	// Select HSI as system clock.
+	RCC -> CFGR &= ~(0b11 << 0); // SW='00'.
+	while (((RCC -> CFGR) & (0b11 << 0)) != 0b00); // // Wait for clock switch (SWS='00').
+	// Peripherals clock prescalers:
+	// HPRE = 1 -> HCLK = SYSCLK = 16MHz.
+	// PPRE1 = 2 -> PCLK1 = HCLK/2 = 8MHz (timers clock is still 2*PCLK1).
+	// PPRE2 = 2 -> PCLK2 = HCLK/2 = 8MHz.
+	RCC -> CFGR &= 0xFFFF030F; // Reset bits 4-7 and 10-15 + HPRE='0000' (1).
+	RCC -> CFGR |= (0b100 << 10) | (0b100 << 13); // PPRE1='100' (2) and PPRE2='100' (2).
+	// Update clocks frequency.
+	rcc_ctx.rcc_sysclk_khz = RCC_STANDBY_SYSCLK_KHZ;
+	rcc_ctx.rcc_pclk1_khz = RCC_STANDBY_PCLK1_KHZ;
+	rcc_ctx.rcc_pclk2_khz = RCC_STANDBY_PCLK2_KHZ;
+}
+
+/* STOP MAIN PLL ONCE HSI IS USED AS SYSTEM CLOCK.
+ * @param:	None.
+ * @return:	None.
+ */
+void RCC_DisableRunPll(void) {
+	// Decrease flash latency once clock is switched (HCLK = 16MHz -> 0 WS).
+	FLASH -> ACR &= ~(0b1111 << 0); // LATENCY=0.
+#ifdef RCC_OVERDRIVE
+	// Disable over-drive mode.
+	PWR -> CR1 &= ~(0b1 << 17); // ODSWEN='0'.
+	PWR -> CR1 &= ~(0b1 << 16); // ODEN='0'.
+	while (((PWR -> CSR1) & (0b1 << 17)) != 0); // Wait for ODSWRDY='0'.
 #endif
+	// Stop main PLL (regulator automatically switches to scale 3 while PLL is off).
+	RCC -> CR &= ~(0b1 << 24); // PLLON='0'.
+	while (((RCC -> CR) & (0b1 << 25)) != 0); // Wait for PLLRDY='0'.
+}
+
+/* ENABLE OR DISABLE THE CLOCK OF PERIPHERALS ONLY USED WHILE THE CAB IS POWERED (TIM5/6/7/8, ADC1 AND DAC).
+ * @param clocks_enabled:	'0' to gate the clocks (registers content is kept), any other value to enable them.
+ * @return:					None.
+ */
+void RCC_EnableDashboardClocks(unsigned char clocks_enabled) {
+	if (clocks_enabled != 0) {
+		RCC -> APB1ENR |= RCC_APB1ENR_DASHBOARD_MASK;
+		RCC -> APB2ENR |= RCC_APB2ENR_DASHBOARD_MASK;
+	}
+	else {
+		RCC -> APB1ENR &= ~RCC_APB1ENR_DASHBOARD_MASK;
+		RCC -> APB2ENR &= ~RCC_APB2ENR_DASHBOARD_MASK;
+	}
+}
+
+/* GET CURRENT SYSTEM CLOCK FREQUENCY.
+ * @param:	None.
+ * @return:	SYSCLK frequency in kHz.
+ */
+unsigned int RCC_GetSysclkKhz(void) {
+	return (rcc_ctx.rcc_sysclk_khz);
+}
+
+/* GET CURRENT APB1 CLOCK FREQUENCY.
+ * @param:	None.
+ * @return:	PCLK1 frequency in kHz.
+ */
+unsigned int RCC_GetPclk1Khz(void) {
+	return (rcc_ctx.rcc_pclk1_khz);
+}
+
+/* GET CURRENT APB2 CLOCK FREQUENCY.
+ * @param:	None.
+ * @return:	PCLK2 frequency in kHz.
+ */
+unsigned int RCC_GetPclk2Khz(void) {
+	return (rcc_ctx.rcc_pclk2_khz);
 }
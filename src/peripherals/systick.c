@@ -0,0 +1,72 @@
+/*
+ * systick.c
+ *
+ *  Created on: 18 oct. 2026
+ *      Author: Ludo
+ */
+
+#include "systick.h"
+
+#include "pcs.h"
+#include "scb_reg.h"
+#include "systick_reg.h"
+
+/*** SYSTICK local macros ***/
+
+#define SYSTICK_RELOAD_MAX	0x00FFFFFF // 24-bits counter.
+
+/*** SYSTICK local functions ***/
+
+#ifdef PCS_ENABLED
+/* SYSTICK INTERRUPT HANDLER.
+ * @param:	None.
+ * @return:	None.
+ */
+void __attribute__((naked)) SysTick_InterruptHandler(void) {
+	// No register is pushed before reading the interrupted PC in the exception stack frame (process stack is not used).
+	__asm volatile (
+		"mrs r0, msp \n"
+		"ldr r0, [r0, #24] \n" // Stacked PC is the first argument.
+		"b PCS_Sample \n" // Tail call, PCS_Sample returns from exception.
+	);
+}
+#endif
+
+/*** SYSTICK functions ***/
+
+/* CONFIGURE SYSTICK TO INTERRUPT PERIODICALLY.
+ * @param period_cycles:	Interrupt period in core clock cycles.
+ * @return:					None.
+ */
+void SYSTICK_Init(unsigned int period_cycles) {
+	unsigned int reload = period_cycles - 1;
+	if (reload > SYSTICK_RELOAD_MAX) {
+		reload = SYSTICK_RELOAD_MAX;
+	}
+	// Disable counter.
+	SYSTICK -> CTRL &= ~(0b1 << 0); // ENABLE='0'.
+	// Use core clock and enable interrupt.
+	SYSTICK -> CTRL |= (0b1 << 2); // CLKSOURCE='1'.
+	SYSTICK -> CTRL |= (0b1 << 1); // TICKINT='1'.
+	SYSTICK -> LOAD = reload;
+	SYSTICK -> VAL = 0;
+	// Highest priority to be able to sample other interrupt handlers (see NVIC_PRIORITY_PERIPHERAL).
+	SCB -> SHPR[11] = 0;
+}
+
+/* START SYSTICK.
+ * @param:	None.
+ * @return:	None.
+ */
+void SYSTICK_Start(void) {
+	SYSTICK -> VAL = 0;
+	SYSTICK -> CTRL |= (0b1 << 0); // ENABLE='1'.
+}
+
+/* STOP SYSTICK.
+ * @param:	None.
+ * @return:	None.
+ */
+void SYSTICK_Stop(void) {
+	SYSTICK -> CTRL &= ~(0b1 << 0); // ENABLE='0'.
+}
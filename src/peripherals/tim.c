@@ -7,41 +7,95 @@
 
 #include "tim.h"
 
+#include "blink.h"
 #include "common.h"
+#include "hist.h"
 #include "kvb.h"
 #include "mano.h"
 #include "mapping.h"
 #include "nvic.h"
+#include "prof.h"
 #include "rcc.h"
 #include "rcc_reg.h"
+#include "tch.h"
+#include "tcm.h"
+#include "timer.h"
 #include "tim_reg.h"
 
 /*** TIM local functions ***/
 
+/* TIM2 INTERRUPT HANDLER.
+ * @param: 	None.
+ * @return: None.
+ */
+void TIM2_InterruptHandler(void) {
+	PROF_START(PROF_ID_TIM2_IRQ);
+	// Compare channel 1 is used by blink engine.
+	if (((TIM2 -> SR) & (0b1 << 1)) != 0) {
+		// Clear flag.
+		TIM2 -> SR = ~(0b1 << 1); // CC1IF='0'.
+		// Update blinking outputs.
+		BLINK_Process();
+	}
+	// Compare channel 2 is used to wake-up the core from sleep mode.
+	if (((TIM2 -> SR) & (0b1 << 2)) != 0) {
+		// Clear flag and disable interrupt (one-shot).
+		TIM2 -> SR = ~(0b1 << 2); // CC2IF='0'.
+		TIM2 -> DIER &= ~(0b1 << 2); // CC2IE='0'.
+	}
+	// Compare channel 3 is used as timer wheel tick.
+	if ((((TIM2 -> SR) & (0b1 << 3)) != 0) && (((TIM2 -> DIER) & (0b1 << 3)) != 0)) {
+		// Clear flag (rc_w0 bits: plain write since a read-modify-write would erase flags set in between).
+		TIM2 -> SR = ~(0b1 << 3); // CC3IF='0'.
+		// Advance timer wheel.
+		TIMER_Process();
+	}
+	PROF_STOP(PROF_ID_TIM2_IRQ);
+}
+
+/* TIM5 INTERRUPT HANDLER.
+ * @param: 	None.
+ * @return: None.
+ */
+void TCM_ITCM_FUNCTION TIM5_InterruptHandler(void) {
+	// Counter restarted from 0 on update event, its value gives the delay of the commutation in us.
+	HIST_Add(HIST_ID_TIM5_LATENCY, (TIM5 -> CNT));
+	PROF_START(PROF_ID_TIM5_IRQ);
+	// Clear flag.
+	TIM5 -> SR &= ~(0b1 << 0); // UIF='0'.
+	// Apply next tachro step.
+	TCH_Commutate();
+	PROF_STOP(PROF_ID_TIM5_IRQ);
+}
+
 /* TIM6 INTERRUPT HANDLER.
  * @param: 	None.
  * @return: None.
  */
-void TIM6_DAC_InterruptHandler(void) {
+void TCM_ITCM_FUNCTION TIM6_DAC_InterruptHandler(void) {
+	// Counter restarted from 0 on update event, its value gives the entry latency in us.
+	HIST_Add(HIST_ID_TIM6_LATENCY, (TIM6 -> CNT));
+	PROF_START(PROF_ID_TIM6_IRQ);
 	// Clear flag.
 	TIM6 -> SR &= ~(0b1 << 0); // UIF='0'.
 	// Perform KVB display sweep.
 	KVB_Sweep();
+	PROF_STOP(PROF_ID_TIM6_IRQ);
 }
 
 /* TIM7 INTERRUPT HANDLER.
  * @param: 	None.
  * @return: None.
  */
-void TIM7_InterruptHandler(void) {
+void TCM_ITCM_FUNCTION TIM7_InterruptHandler(void) {
+	// Counter restarted from 0 on update event, its value gives the entry latency in us.
+	HIST_Add(HIST_ID_TIM7_LATENCY, (TIM7 -> CNT));
+	PROF_START(PROF_ID_TIM7_IRQ);
 	// Clear flag.
 	TIM7 -> SR &= ~(0b1 << 0); // UIF='0'.
-	// Perform manometers needle control.
-	MANO_NeedleTask(&(lsmcu_ctx.lsmcu_mano_cp));
-	MANO_NeedleTask(&(lsmcu_ctx.lsmcu_mano_re));
-	MANO_NeedleTask(&(lsmcu_ctx.lsmcu_mano_cg));
-	MANO_NeedleTask(&(lsmcu_ctx.lsmcu_mano_cf1));
-	MANO_NeedleTask(&(lsmcu_ctx.lsmcu_mano_cf2));
+	// Perform due needle steps and program next one.
+	MANOS_StepScheduler();
+	PROF_STOP(PROF_ID_TIM7_IRQ);
 }
 
 /*** TIM functions ***/
@@ -59,14 +113,47 @@ void TIM2_Init(void) {
 	TIM2 -> DIER &= ~(0b1 << 0); // // Disable interrupt (UIE='0').
 	TIM2 -> SR &= ~(0b1 << 0); // UIF='0'.
 	// Set PSC and ARR registers to reach 1 ms.
-	TIM2 -> PSC = (2 * RCC_PCLK1_KHZ) - 1; // TIM2 input clock = (2*PCLK1)/((2*PLCK1-1)+1) = 1kHz.
+	TIM2 -> PSC = (2 * RCC_GetPclk1Khz()) - 1; // TIM2 input clock = (2*PCLK1)/((2*PLCK1-1)+1) = 1kHz.
 	TIM2 -> ARR = 0xFFFFFFFF; // No overflow (49 days).
+	// Configure channel 1 in frozen output compare mode (used as timebase for blink engine).
+	TIM2 -> CCMR1 &= 0xFFFFFF00; // CC1S='00' and OC1M='000'.
+	TIM2 -> CCR1 = 0;
+	TIM2 -> DIER &= ~(0b1 << 1); // CC1IE='0'.
+	// Configure channel 2 in frozen output compare mode (used to wake-up from sleep mode).
+	TIM2 -> CCMR1 &= 0xFFFF00FF; // CC2S='00' and OC2M='000'.
+	TIM2 -> CCR2 = 0;
+	TIM2 -> DIER &= ~(0b1 << 2); // CC2IE='0'.
+	// Configure channel 3 in frozen output compare mode (used as timer wheel tick).
+	TIM2 -> CCMR2 &= 0xFFFFFF00; // CC3S='00' and OC3M='000'.
+	TIM2 -> CCR3 = 0;
+	TIM2 -> DIER &= ~(0b1 << 3); // CC3IE='0'.
 	// Generate event to update registers.
 	TIM2 -> EGR |= (0b1 << 0); // UG='1'.
+	NVIC_SetPriority(IT_TIM2, NVIC_PRIORITY_PERIPHERAL);
 	// Start counter.
 	TIM2 -> CR1 |= (0b1 << 0); // CEN='1'.
 }
 
+/* SWITCH PCLK1 FREQUENCY ON A MILLISECOND EDGE AND UPDATE TIM2 PRESCALER ACCORDINGLY (MILLISECONDS COUNT IS KEPT).
+ * @param clock_switch:	RCC function which changes PCLK1 (must only last a few cycles).
+ * @return:				None.
+ */
+void TIM2_SwitchClock(void (*clock_switch)(void)) {
+	unsigned int ms_count = 0;
+	NVIC_MaskAllInterrupts();
+	// Wait for a millisecond edge: prescaler counter has just restarted from 0, so the update event below
+	// only discards the cycles spent in the switch (instead of up to 1ms of elapsed time).
+	ms_count = (TIM2 -> CNT);
+	while ((TIM2 -> CNT) == ms_count);
+	ms_count = (TIM2 -> CNT);
+	clock_switch();
+	// Prescaler is preloaded and counter never overflows, generate event to apply it immediately (counter is reset by the event).
+	TIM2 -> PSC = (2 * RCC_GetPclk1Khz()) - 1;
+	TIM2 -> EGR |= (0b1 << 0); // UG='1'.
+	TIM2 -> CNT = ms_count;
+	NVIC_UnmaskAllInterrupts();
+}
+
 /* RETURNS THE NUMBER OF MILLISECONDS ELLAPSED SINCE START-UP.
  * @param: 	None.
  * @return:	Number of milliseconds (32-bits word) ellapsed since start-up.
@@ -84,6 +171,80 @@ void TIM2_DelayMs(unsigned int ms_to_wait) {
 	while (TIM2_GetMs() < (start_ms + ms_to_wait));
 }
 
+/* SET TIM2 CHANNEL 1 COMPARE VALUE.
+ * @param compare_ms:	Absolute time (in ms) at which compare event will occur.
+ * @return:				None.
+ */
+void TIM2_SetCompareMs(unsigned int compare_ms) {
+	TIM2 -> CCR1 = compare_ms;
+}
+
+/* ENABLE OR DISABLE TIM2 CHANNEL 1 COMPARE INTERRUPT.
+ * @param it_enabled:	'0' to disable interrupt, any other value to enable it.
+ * @return:				None.
+ */
+void TIM2_EnableCompareInterrupt(unsigned char it_enabled) {
+	if (it_enabled != 0) {
+		if (((TIM2 -> DIER) & (0b1 << 1)) == 0) {
+			// Clear flag set by previous matches.
+			TIM2 -> SR = ~(0b1 << 1); // CC1IF='0'.
+			TIM2 -> DIER |= (0b1 << 1); // CC1IE='1'.
+		}
+	}
+	else {
+		TIM2 -> DIER &= ~(0b1 << 1); // CC1IE='0'.
+	}
+}
+
+/* FORCE TIM2 CHANNEL 1 COMPARE EVENT.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIM2_ForceCompareEvent(void) {
+	TIM2 -> EGR |= (0b1 << 1); // CC1G='1'.
+}
+
+/* PROGRAM A WAKE-UP INTERRUPT ON TIM2 CHANNEL 2.
+ * @param wake_up_ms:	Absolute time (in ms) at which the interrupt will occur.
+ * @return:				None.
+ */
+void TIM2_SetWakeUpMs(unsigned int wake_up_ms) {
+	TIM2 -> CCR2 = wake_up_ms;
+	TIM2 -> SR = ~(0b1 << 2); // CC2IF='0'.
+	TIM2 -> DIER |= (0b1 << 2); // CC2IE='1'.
+	NVIC_EnableInterrupt(IT_TIM2);
+}
+
+/* PROGRAM THE NEXT TIMER WHEEL TICK ON TIM2 CHANNEL 3.
+ * @param tick_ms:	Absolute time (in ms) at which the interrupt will occur.
+ * @return:			None.
+ */
+void TIM2_SetTickMs(unsigned int tick_ms) {
+	TIM2 -> CCR3 = tick_ms;
+	if (((TIM2 -> DIER) & (0b1 << 3)) == 0) {
+		// Clear flag set by previous matches.
+		TIM2 -> SR = ~(0b1 << 3); // CC3IF='0'.
+		TIM2 -> DIER |= (0b1 << 3); // CC3IE='1'.
+		NVIC_EnableInterrupt(IT_TIM2);
+	}
+}
+
+/* DISABLE TIMER WHEEL TICK.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIM2_DisableTick(void) {
+	TIM2 -> DIER &= ~(0b1 << 3); // CC3IE='0'.
+}
+
+/* FORCE TIM2 CHANNEL 3 COMPARE EVENT.
+ * @param:	None.
+ * @return:	None.
+ */
+void TIM2_ForceTickEvent(void) {
+	TIM2 -> EGR |= (0b1 << 3); // CC3G='1'.
+}
+
 /* CONFIGURE TIM5 FOR TACHRO STEPPING.
  * @param:	None.
  * @return:	None.
@@ -93,6 +254,7 @@ void TIM5_Init(void) {
 	RCC -> APB1ENR |= (0b1 << 3); // TIM5EN='1'.
 	// Configure peripheral.
 	TIM5 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	TIM5 -> CR1 |= (0b1 << 7) | (0b1 << 2); // ARPE='1' (new period is applied on next step) and URS='1' (UG does not trigger interrupt).
 	TIM5 -> CNT = 0;
 	TIM5 -> DIER &= ~(0b1 << 0); // // Disable interrupt (UIE='0').
 	TIM5 -> SR &= ~(0b1 << 0); // UIF='0'.
@@ -101,6 +263,10 @@ void TIM5_Init(void) {
 	TIM5 -> ARR = 0; // Default value.
 	// Generate event to update registers.
 	TIM5 -> EGR |= (0b1 << 0); // UG='1'.
+	// Enable interrupt.
+	TIM5 -> DIER |= (0b1 << 0); // UIE='1'.
+	TIM5 -> SR &= ~(0b1 << 0); // UIF='0'.
+	NVIC_SetPriority(IT_TIM5, NVIC_PRIORITY_PERIPHERAL);
 }
 
 /* START TIM5.
@@ -108,7 +274,11 @@ void TIM5_Init(void) {
  * @return: None.
  */
 void TIM5_Start(void) {
+	// Load period and reset counter.
+	TIM5 -> EGR |= (0b1 << 0); // UG='1'.
+	TIM5 -> SR &= ~(0b1 << 0); // UIF='0'.
 	// Enable counter.
+	NVIC_EnableInterrupt(IT_TIM5);
 	TIM5 -> CR1 |= (0b1 << 0); // CEN='1'.
 }
 
@@ -119,32 +289,26 @@ void TIM5_Start(void) {
 void TIM5_Stop(void) {
 	// Disable and reset counter.
 	TIM5 -> CR1 &= ~(0b1 << 0); // CEN='0'.
+	NVIC_DisableInterrupt(IT_TIM5);
 	TIM5 -> CNT = 0;
 	TIM5 -> SR &= ~(0b1 << 0);
 }
 
-/* SET TIM5 ARR REGISTER VALUE TO CHANGE OVERFLOW PERIOD.
- * @param arr_value:	New value of ARR register.
- * @return:				None.
- */
-void TIM5_SetDelayUs(unsigned int delay_us) {
-	TIM5 -> ARR = delay_us; // <delay_us> fronts @ 1MHz = <delay_us> s.
-}
-
-/* GET TIM5 UPDATE EVENT FLAG.
+/* GET TIM5 STATE.
  * @param:	None.
- * @return:	UIF flag status (0/1).
+ * @return:	'1' if TIM5 counter is enabled, '0' otherwise.
  */
-unsigned char TIM5_GetUifFlag(void) {
-	return ((TIM5 -> SR) & (0b1 << 0));
+unsigned char TIM5_IsRunning(void) {
+	return ((((TIM5 -> CR1) & (0b1 << 0)) != 0) ? 1 : 0);
 }
 
-/* CLEAR TIM5 UPDATE EVENT FLAG.
- * @param:	None.
- * @return:	None.
+/* SET TIM5 PERIOD (APPLIED ON NEXT UPDATE EVENT).
+ * @param delay_us:	Delay between two update events in s.
+ * @return:			None.
  */
-void TIM5_ClearUifFlag(void) {
-	TIM5 -> SR &= ~(0b1 << 0);
+void TIM5_SetDelayUs(unsigned int delay_us) {
+	// Counter runs from 0 to ARR included: <delay_us> fronts @ 1MHz = <delay_us> s (ARR='0' would block the counter).
+	TIM5 -> ARR = (delay_us > 1) ? (delay_us - 1) : 1;
 }
 
 /* CONFIGURE TIM6 FOR KVB DISPLAY.
@@ -159,14 +323,15 @@ void TIM6_Init(void) {
 	TIM6 -> CNT = 0;
 	TIM6 -> DIER &= ~(0b1 << 0); // // Disable interrupt (UIE='0').
 	TIM6 -> SR &= ~(0b1 << 0); // UIF='0'.
-	// Set PSC and ARR registers to reach 2ms.
-	TIM6 -> PSC = ((2 * RCC_PCLK1_KHZ) / 50) - 1; // TIM6 input clock = (2*PCLK1)/((((2*PCLK1)/50)-1)+1) = 50kHz.
-	TIM6 -> ARR = 100; // 100 fronts @ 50kHz = 2ms.
+	// Set PSC and ARR registers to reach 2ms (ARR is then updated on-the-fly by KVB sweep).
+	TIM6 -> PSC = ((2 * RCC_PCLK1_KHZ) / 1000) - 1; // TIM6 input clock = (2*PCLK1)/((((2*PCLK1)/1000)-1)+1) = 1MHz.
+	TIM6 -> ARR = 1999; // 2000 fronts @ 1MHz = 2ms.
 	// Generate event to update registers.
 	TIM6 -> EGR |= (0b1 << 0); // UG='1'.
 	// Enable interrupt.
 	TIM6 -> DIER |= (0b1 << 0); // UIE='1'.
 	TIM6 -> SR &= ~(0b1 << 0); // UIF='0'.
+	NVIC_SetPriority(IT_TIM6_DAC, NVIC_PRIORITY_PERIPHERAL);
 }
 
 /* START TIM6.
@@ -189,6 +354,23 @@ void TIM6_Stop(void) {
 	TIM6 -> CNT = 0;
 }
 
+/* GET TIM6 STATE.
+ * @param:	None.
+ * @return:	'1' if TIM6 counter is enabled, '0' otherwise.
+ */
+unsigned char TIM6_IsRunning(void) {
+	return ((((TIM6 -> CR1) & (0b1 << 0)) != 0) ? 1 : 0);
+}
+
+/* SET TIM6 ARR REGISTER VALUE TO CHANGE OVERFLOW PERIOD.
+ * @param delay_us:	Delay until next update event in s.
+ * @return:			None.
+ */
+void TCM_ITCM_FUNCTION TIM6_SetDelayUs(unsigned int delay_us) {
+	// Counter runs from 0 to ARR included: <delay_us> fronts @ 1MHz = <delay_us> s (ARR='0' would block the counter).
+	TIM6 -> ARR = (delay_us > 1) ? (delay_us - 1) : 1;
+}
+
 /* CONFIGURE TIM7 FOR MANOMETERS.
  * @param:	None.
  * @return:	None.
@@ -201,21 +383,22 @@ void TIM7_Init(void) {
 	TIM7 -> CNT = 0;
 	TIM7 -> DIER &= ~(0b1 << 0); // // Disable interrupt (UIE='0').
 	TIM7 -> SR &= ~(0b1 << 0); // UIF='0'.
-	// Set PSC and ARR registers to reach 1ms.
+	// Set PSC and ARR registers to reach 1ms (ARR is then updated on-the-fly by manometers step scheduler).
 	TIM7 -> PSC = ((2 * RCC_PCLK1_KHZ) / 1000) - 1; // TIM7 input clock = (2*PCLK1)/((((2*PCLK1)/1000)-1)+1) = 1MHz.
-	TIM7 -> ARR = 100; // 100 fronts @ 1MHz = 100s.
+	TIM7 -> ARR = 999; // 1000 fronts @ 1MHz = 1ms.
 	// Generate event to update registers.
 	TIM7 -> EGR |= (0b1 << 0); // UG='1'.
 	// Enable interrupt.
 	TIM7 -> DIER |= (0b1 << 0); // UIE='1'.
 	TIM7 -> SR &= ~(0b1 << 0); // UIF='0'.
+	NVIC_SetPriority(IT_TIM7, NVIC_PRIORITY_PERIPHERAL);
 }
 
 /* START TIM7.
  * @param:	None.
  * @return: None.
  */
-void TIM7_Start(void) {
+void TCM_ITCM_FUNCTION TIM7_Start(void) {
 	// Enable counter.
 	TIM7 -> CR1 |= (0b1 << 0); // CEN='1'.
 	NVIC_EnableInterrupt(IT_TIM7);
@@ -225,13 +408,54 @@ void TIM7_Start(void) {
  * @param: 	None.
  * @return:	None.
  */
-void TIM7_Stop(void) {
+void TCM_ITCM_FUNCTION TIM7_Stop(void) {
 	// Disable and reset counter.
 	TIM7 -> CR1 &= ~(0b1 << 0); // CEN='0'.
 	TIM7 -> CNT = 0;
 	NVIC_DisableInterrupt(IT_TIM7);
 }
 
+/* GET TIM7 STATE.
+ * @param:	None.
+ * @return:	'1' if TIM7 counter is enabled, '0' otherwise.
+ */
+unsigned char TIM7_IsRunning(void) {
+	return ((((TIM7 -> CR1) & (0b1 << 0)) != 0) ? 1 : 0);
+}
+
+/* SET TIM7 PERIOD.
+ * @param delay_us:	Delay before next update event in s (1 to 65535).
+ * @return:			None.
+ */
+void TCM_ITCM_FUNCTION TIM7_SetDelayUs(unsigned int delay_us) {
+	// Counter runs from 0 to ARR included: <delay_us> fronts @ 1MHz = <delay_us> s (ARR='0' would block the counter).
+	TIM7 -> ARR = (delay_us > 1) ? (delay_us - 1) : 1;
+}
+
+/* GET TIM7 COUNTER VALUE.
+ * @param:		None.
+ * @return:		Time elapsed since last update event in s.
+ */
+unsigned int TCM_ITCM_FUNCTION TIM7_GetCounterUs(void) {
+	return (TIM7 -> CNT);
+}
+
+/* RESET TIM7 COUNTER.
+ * @param:	None.
+ * @return:	None.
+ */
+void TCM_ITCM_FUNCTION TIM7_ResetCounter(void) {
+	TIM7 -> CNT = 0;
+}
+
+/* GET TIM7 UPDATE INTERRUPT FLAG.
+ * @param:	None.
+ * @return:	UIF bit value.
+ */
+unsigned char TIM7_GetUifFlag(void) {
+	return ((TIM7 -> SR) & (0b1 << 0));
+}
+
 /* CONFIGURE TIM8 IN PWM MODE FOR LVAL BLINKLING.
  * @param:	None.
  * @return: None.
@@ -266,6 +490,30 @@ void TIM8_SetDutyCycle(unsigned char duty_cycle) {
 	TIM8 -> CCR1 = (((duty_cycle) % 101) * (TIM8 -> ARR)) / 100; // % 101 because duty cycle ranges from 0 to 100 included.
 }
 
+/* SET TIM8 UPDATE EVENT RATE THANKS TO REPETITION COUNTER.
+ * @param pwm_periods:	Number of PWM periods between two update events (1 to 65536).
+ * @return:				None.
+ */
+void TIM8_SetUpdatePeriods(unsigned int pwm_periods) {
+	// Set repetition counter.
+	TIM8 -> RCR = (pwm_periods > 0) ? ((pwm_periods - 1) & 0xFFFF) : 0;
+	// Generate event to load repetition counter (DMA request is not yet enabled).
+	TIM8 -> EGR |= (0b1 << 0); // UG='1'.
+}
+
+/* ENABLE OR DISABLE TIM8 UPDATE DMA REQUEST.
+ * @param dma_enabled:	'0' to disable DMA request, any other value to enable it.
+ * @return:				None.
+ */
+void TIM8_EnableUpdateDma(unsigned char dma_enabled) {
+	if (dma_enabled != 0) {
+		TIM8 -> DIER |= (0b1 << 8); // UDE='1'.
+	}
+	else {
+		TIM8 -> DIER &= ~(0b1 << 8); // UDE='0'.
+	}
+}
+
 /* START TIM8.
  * @param:	None.
  * @return: None.
@@ -288,3 +536,11 @@ void TIM8_Stop(void) {
 	TIM8 -> CR1 &= ~(0b1 << 0); // CEN='0'.
 	TIM8 -> CNT = 0;
 }
+
+/* GET TIM8 STATE.
+ * @param:	None.
+ * @return:	'1' if TIM8 counter is enabled, '0' otherwise.
+ */
+unsigned char TIM8_IsRunning(void) {
+	return ((((TIM8 -> CR1) & (0b1 << 0)) != 0) ? 1 : 0);
+}
@@ -11,8 +11,11 @@
 #include "lssgkcu.h"
 #include "mapping.h"
 #include "nvic.h"
+#include "prof.h"
 #include "rcc.h"
 #include "rcc_reg.h"
+#include "sched.h"
+#include "tcm.h"
 #include "usart_reg.h"
 
 /*** USART local macros ***/
@@ -20,7 +23,7 @@
 // Baud rate.
 #define BAUD_RATE 				9600
 // Buffer sizes.
-#define USART_TX_BUFFER_SIZE	32
+#define USART_TX_BUFFER_SIZE	64 // Holds one line of diagnostics dump.
 #define USART_RX_BUFFER_SIZE	32
 
 /*** USART local structures ***/
@@ -33,7 +36,7 @@ typedef struct {
 
 /*** USART local global variables ***/
 
-static USART_Context usart1_ctx;
+static USART_Context usart1_ctx TCM_DTCM_DATA;
 
 /*** USART local functions ***/
 
@@ -41,7 +44,8 @@ static USART_Context usart1_ctx;
  * @param:	None.
  * @return:	None.
  */
-void USART1_InterruptHandler(void) {
+void TCM_ITCM_FUNCTION USART1_InterruptHandler(void) {
+	PROF_START(PROF_ID_USART1_IRQ);
 	// TX.
 	if (((USART1 -> ISR) & (0b1 << 7)) != 0) { // TXE='1'.
 		if ((usart1_ctx.tx_read_idx) != (usart1_ctx.tx_write_idx)) {
@@ -63,7 +67,9 @@ void USART1_InterruptHandler(void) {
 		// Get and store new byte into RX buffer.
 		unsigned char rx_byte = USART1 -> RDR;
 		LSSGKCU_FillRxBuffer(rx_byte);
+		SCHED_PostEvent(SCHED_EVENT_USART1_RX);
 	}
+	PROF_STOP(PROF_ID_USART1_IRQ);
 }
 
 /* APPEND A NEW BYTE TO TX BUFFER AND MANAGE INDEX ROLL-OVER.
@@ -111,14 +117,17 @@ void USART1_Init(void) {
 	USART1 -> CR1 = 0; // M='00' and OVER8='0'.
 	USART1 -> CR2 = 0;
 	USART1 -> CR3 = 0;
-	// Baud rate.
-	USART1 -> BRR = (RCC_PCLK2_KHZ * 1000) / (BAUD_RATE); // USART clock = PCLK2 (APB2 peripheral).
+	// Baud rate: USART clock = HSI, so that BRR is kept when system clock is switched between PLL and HSI.
+	RCC -> DKCFGR2 &= ~(0b11 << 0);
+	RCC -> DKCFGR2 |= (0b10 << 0); // USART1SEL='10' (HSI).
+	USART1 -> BRR = (RCC_HSI_KHZ * 1000) / (BAUD_RATE);
 	// Enable transmitter and receiver.
 	USART1 -> CR1 |= (0b1 << 3); // TE='1'.
 	USART1 -> CR1 |= (0b1 << 2); // RE='1'.
 	USART1 -> CR1 |= (0b1 << 5); // // Enable RX interrupt (RXNEIE='1').
 	// Enable peripheral.
 	USART1 -> CR1 |= (0b1 << 0); // UE='1'.
+	NVIC_SetPriority(IT_USART1, NVIC_PRIORITY_PERIPHERAL);
 	NVIC_EnableInterrupt(IT_USART1);
 }
 
@@ -168,3 +177,14 @@ void USART1_SendByte(unsigned char tx_byte, USART_Format format) {
 	USART1 -> CR1 |= (0b1 << 7); // TXEIE = '1'.
 	NVIC_EnableInterrupt(IT_USART1);
 }
+
+/* SEND A 32-BITS WORD THROUGH USART IN HEXADECIMAL FORMAT (MOST SIGNIFICANT BYTE FIRST).
+ * @param tx_word:	The word to send.
+ * @return:			None.
+ */
+void USART1_SendWord(unsigned int tx_word) {
+	USART1_SendByte(((tx_word >> 24) & 0xFF), USART_FORMAT_HEXADECIMAL);
+	USART1_SendByte(((tx_word >> 16) & 0xFF), USART_FORMAT_HEXADECIMAL);
+	USART1_SendByte(((tx_word >> 8) & 0xFF), USART_FORMAT_HEXADECIMAL);
+	USART1_SendByte(((tx_word >> 0) & 0xFF), USART_FORMAT_HEXADECIMAL);
+}
@@ -70,6 +70,43 @@ LoopFillZerobss:
 	cmp	r2, r3
 	bcc	FillZerobss
 
+/* Copy the ITCM code from flash to ITCM RAM */
+  movs	r1, #0
+  b	LoopCopyItcmInit
+
+CopyItcmInit:
+	ldr	r3, =_siitcm
+	ldr	r3, [r3, r1]
+	str	r3, [r0, r1]
+	adds	r1, r1, #4
+
+LoopCopyItcmInit:
+	ldr	r0, =_sitcm
+	ldr	r3, =_eitcm
+	adds	r2, r0, r1
+	cmp	r2, r3
+	bcc	CopyItcmInit
+
+/* Copy the DTCM data initializers from flash to DTCM RAM */
+  movs	r1, #0
+  b	LoopCopyDtcmInit
+
+CopyDtcmInit:
+	ldr	r3, =_sidtcm
+	ldr	r3, [r3, r1]
+	str	r3, [r0, r1]
+	adds	r1, r1, #4
+
+LoopCopyDtcmInit:
+	ldr	r0, =_sdtcm
+	ldr	r3, =_edtcm
+	adds	r2, r0, r1
+	cmp	r2, r3
+	bcc	CopyDtcmInit
+/* Ensure the copied code is visible to instruction fetch. */
+	dsb
+	isb
+
 /* Call the clock system intitialization function.*/
     bl  SystemInit
 /* Call static constructors */
@@ -122,7 +159,7 @@ g_pfnVectors:
 	.word	DebugMon_Handler
 	.word	0
 	.word	PendSV_Handler
-	.word	SysTick_Handler
+	.word	SysTick_InterruptHandler
 	.word	0 // 0 = WWDG.
 	.word	0 // 1 = PVD.
 	.word	0 // 2 = TAMP_STAMP.
@@ -151,7 +188,7 @@ g_pfnVectors:
 	.word	0 // 25 = TIM1_UP_TIM10.
 	.word	0 // 26 = TIM1_TRG_COM_TIM11.
 	.word	0 // 27 = TIM1_CC.
-	.word	0 // 28 = TIM2.
+	.word	TIM2_InterruptHandler // 28 = TIM2.
 	.word	0 // 29 = TIM3.
 	.word	0 // 30 = TIM4.
 	.word	0 // 31 = I2C1_EV.
@@ -173,7 +210,7 @@ g_pfnVectors:
 	.word	0 // 47 = DMA1_Stream7
 	.word	0 // 48 = FSMC.
 	.word	0 // 49 = SDMMC1.
-	.word	0 // 50 = TIM5.
+	.word	TIM5_InterruptHandler // 50 = TIM5.
 	.word	0 // 51 = SPI3.
 	.word	0 // 52 = UART4.
 	.word	0 // 53 = UART5.
@@ -254,8 +291,8 @@ g_pfnVectors:
 	.weak	PendSV_Handler
 	.thumb_set PendSV_Handler,Default_Handler
 
-	.weak	SysTick_Handler
-	.thumb_set SysTick_Handler,Default_Handler
+	.weak	SysTick_InterruptHandler
+	.thumb_set SysTick_InterruptHandler,Default_Handler
 
 	.weak	SystemInit
 	
@@ -265,6 +302,12 @@ g_pfnVectors:
 	.weak	USART1_InterruptHandler
 	.thumb_set USART1_InterruptHandler,Default_Handler
 
+	.weak	TIM2_InterruptHandler
+	.thumb_set TIM2_InterruptHandler,Default_Handler
+
+	.weak	TIM5_InterruptHandler
+	.thumb_set TIM5_InterruptHandler,Default_Handler
+
 	.weak	TIM6_DAC_InterruptHandler
 	.thumb_set TIM6_DAC_InterruptHandler,Default_Handler
 
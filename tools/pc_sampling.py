@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# pc_sampling.py
+#
+#  Created on: 18 oct. 2026
+#      Author: Ludo
+#
+# Map the PC sampler dump (LSMCU_IN_PCS_DUMP command, firmware built with PCS_ENABLED)
+# to the functions of the ELF file and print the hottest ones.
+#
+# Usage: pc_sampling.py <firmware.elf> <dump.txt> [--nm arm-none-eabi-nm] [--top 30]
+#
+# Dump lines are "<bucket> <count>" in hexadecimal, bucket FFFF gives the samples outside code ranges.
+# Buckets beyond the flash range map the functions copied to ITCM RAM.
+
+import argparse
+import bisect
+import subprocess
+import sys
+
+# Must match pcs.h.
+PCS_CODE_BASE_ADDRESS = 0x08000000
+PCS_BUCKET_SIZE_SHIFT = 6
+PCS_CODE_BUCKETS_NUMBER = 2048
+PCS_ITCM_BASE_ADDRESS = 0x00000000
+PCS_DUMP_OUTSIDE_BUCKET = 0xFFFF
+
+
+def read_symbols(nm, elf):
+    # Return the list of (address, size, name) of code symbols sorted by address.
+    output = subprocess.run([nm, "--defined-only", "--numeric-sort", "--print-size", elf],
+                            check=True, capture_output=True, text=True).stdout
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if (len(fields) == 4) and (fields[2] in "tTwW"):
+            # Remove thumb bit.
+            symbols.append((int(fields[0], 16) & ~1, int(fields[1], 16), fields[3]))
+    return symbols
+
+
+def read_dump(dump):
+    # Return the dictionary {bucket: count} and the number of samples outside code range.
+    buckets = {}
+    outside = 0
+    with open(dump) as dump_file:
+        for line in dump_file:
+            fields = line.split()
+            if len(fields) != 2:
+                continue
+            try:
+                bucket = int(fields[0], 16)
+                count = int(fields[1], 16)
+            except ValueError:
+                continue
+            if bucket == PCS_DUMP_OUTSIDE_BUCKET:
+                outside = count
+            else:
+                buckets[bucket] = count
+    return buckets, outside
+
+
+def bucket_address(bucket):
+    # Return the start address of a bucket (ITCM buckets follow flash buckets).
+    if bucket >= PCS_CODE_BUCKETS_NUMBER:
+        return PCS_ITCM_BASE_ADDRESS + ((bucket - PCS_CODE_BUCKETS_NUMBER) << PCS_BUCKET_SIZE_SHIFT)
+    return PCS_CODE_BASE_ADDRESS + (bucket << PCS_BUCKET_SIZE_SHIFT)
+
+
+def map_buckets(symbols, buckets):
+    # Share the samples of each bucket between the functions it overlaps, in proportion of the overlap.
+    addresses = [symbol[0] for symbol in symbols]
+    bucket_size = 1 << PCS_BUCKET_SIZE_SHIFT
+    functions = {}
+    for bucket, count in buckets.items():
+        start = bucket_address(bucket)
+        end = start + bucket_size
+        overlaps = []
+        idx = max(bisect.bisect_right(addresses, start) - 1, 0)
+        while (idx < len(symbols)) and (symbols[idx][0] < end):
+            address, size, name = symbols[idx]
+            overlap = min(end, address + max(size, 1)) - max(start, address)
+            if overlap > 0:
+                overlaps.append((name, overlap))
+            idx += 1
+        if not overlaps:
+            overlaps = [("<unknown@0x%08X>" % start, 1)]
+        total = sum(overlap for _, overlap in overlaps)
+        for name, overlap in overlaps:
+            functions[name] = functions.get(name, 0) + (count * overlap / total)
+    return functions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Map PC sampler dump to firmware functions.")
+    parser.add_argument("elf", help="firmware ELF file")
+    parser.add_argument("dump", help="text file containing the serial dump")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm tool of the toolchain")
+    parser.add_argument("--top", type=int, default=30, help="number of functions to print")
+    args = parser.parse_args()
+    buckets, outside = read_dump(args.dump)
+    total = sum(buckets.values()) + outside
+    if total == 0:
+        sys.exit("No sample found in dump.")
+    functions = map_buckets(read_symbols(args.nm, args.elf), buckets)
+    print("%d samples (%d outside code range)." % (total, outside))
+    for name, count in sorted(functions.items(), key=lambda item: item[1], reverse=True)[:args.top]:
+        print("%6.2f%%  %8.1f  %s" % ((100.0 * count) / total, count, name))
+
+
+if __name__ == "__main__":
+    main()